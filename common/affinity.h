@@ -0,0 +1,142 @@
+#ifndef COMMON_AFFINITY_H
+#define COMMON_AFFINITY_H
+
+// 线程绑核工具：把当前线程或当前线程发起的 OpenMP 线程组绑定到指定核心。
+// libgomp 中每个主线程的线程池在并行区之间复用，所以绑定一次即可长期生效。
+// 非 Linux 平台上为空操作并返回 false。
+//
+// 绑核由引擎决定（plan_cpus + pin_omp_team），不依赖 OMP_PROC_BIND / OMP_PLACES：
+//   BIND_COMPACT  先占满一个 NUMA 节点再用下一个，线程之间共享末级缓存
+//   BIND_SPREAD   在各节点之间轮流分配，聚合所有插槽的内存带宽
+
+#include <cstring>
+#include <vector>
+#include <omp.h>
+#include "numa.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace affinity {
+
+// 可用逻辑核数
+inline int num_cpus()
+{
+#if defined(__linux__)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#else
+    return omp_get_num_procs();
+#endif
+}
+
+// cpu 为逻辑核编号（可以大于在线核数，编号不一定连续）；超出 cpu_set_t 范围时返回 false，
+// 不存在或不可用的核由 sched_setaffinity 拒绝
+inline bool pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// 启动 cpus.size() 个线程的并行区，第 t 个线程绑定到 cpus[t]
+inline bool pin_omp_team(const std::vector<int>& cpus)
+{
+    if (cpus.empty())
+        return false;
+    bool ok = true;
+    #pragma omp parallel num_threads((int)cpus.size()) reduction(&&:ok)
+    {
+        int t = omp_get_thread_num();
+        ok = pin_current_thread(cpus[t % cpus.size()]);
+    }
+    return ok;
+}
+
+// 连续核心区间 [first, first + count)
+inline std::vector<int> cpu_range(int first, int count)
+{
+    std::vector<int> cpus(count);
+    for (int i = 0; i < count; ++i)
+        cpus[i] = first + i;
+    return cpus;
+}
+
+enum Binding
+{
+    BIND_NONE = 0,
+    BIND_COMPACT,
+    BIND_SPREAD
+};
+
+// count 个线程依次使用的核心；核数不够时循环复用
+inline std::vector<int> plan_cpus(int count, Binding binding)
+{
+    std::vector<numa::Node> nodes = numa::topology(num_cpus());
+    std::vector<int> order;
+    if (binding == BIND_SPREAD)
+    {
+        for (size_t i = 0; ; ++i)
+        {
+            bool any = false;
+            for (size_t n = 0; n < nodes.size(); ++n)
+            {
+                if (i < nodes[n].cpus.size())
+                {
+                    order.push_back(nodes[n].cpus[i]);
+                    any = true;
+                }
+            }
+            if (!any)
+                break;
+        }
+    }
+    else
+    {
+        for (size_t n = 0; n < nodes.size(); ++n)
+            order.insert(order.end(), nodes[n].cpus.begin(), nodes[n].cpus.end());
+    }
+
+    std::vector<int> cpus(count);
+    for (int i = 0; i < count; ++i)
+        cpus[i] = order[i % order.size()];
+    return cpus;
+}
+
+// 命令行形式："none" / "compact" / "spread"
+inline bool parse_binding(const char* text, Binding& binding)
+{
+    if (std::strcmp(text, "none") == 0)
+        binding = BIND_NONE;
+    else if (std::strcmp(text, "compact") == 0)
+        binding = BIND_COMPACT;
+    else if (std::strcmp(text, "spread") == 0)
+        binding = BIND_SPREAD;
+    else
+        return false;
+    return true;
+}
+
+inline const char* binding_name(Binding binding)
+{
+    switch (binding)
+    {
+    case BIND_COMPACT: return "compact";
+    case BIND_SPREAD: return "spread";
+    default: return "none";
+    }
+}
+
+} // namespace affinity
+
+#endif // COMMON_AFFINITY_H
@@ -0,0 +1,207 @@
+#ifndef COMMON_NUMA_H
+#define COMMON_NUMA_H
+
+// NUMA 拓扑和内存放置策略，不依赖 libnuma：拓扑读 /sys/devices/system/node，
+// 放置直接调用 mbind 系统调用。
+//
+// 三种放置策略：
+//   POLICY_FIRST_TOUCH  默认，页面落在第一次写它的线程所在节点；
+//                       需要线程已绑核，且用与计算相同的划分做 first-touch
+//   POLICY_INTERLEAVE   页面轮流分布在所有节点，适合被所有线程共同读取的数据
+//   POLICY_BIND         全部页面放在指定节点（单实例只用一个插槽时）
+//
+// 节点编号用 sysfs 中的真实编号，可以不连续（节点下线或固件编号有空缺），掩码按编号构造。
+//
+// mbind 带 MPOL_MF_MOVE，已经被访问过的页面也会迁移过去。
+// 非 Linux 平台或单节点机器上 interleave / bind 为空操作。
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace numa {
+
+enum Policy
+{
+    POLICY_FIRST_TOUCH = 0,
+    POLICY_INTERLEAVE,
+    POLICY_BIND
+};
+
+// 解析 "0-3,8,10-11" 形式的 cpulist
+inline std::vector<int> parse_cpulist(const std::string& list)
+{
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size())
+    {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos)
+            end = list.size();
+        std::string item = list.substr(pos, end - pos);
+        int first = 0, last = 0;
+        if (std::sscanf(item.c_str(), "%d-%d", &first, &last) == 2)
+        {
+            for (int c = first; c <= last; ++c)
+                cpus.push_back(c);
+        }
+        else if (std::sscanf(item.c_str(), "%d", &first) == 1)
+        {
+            cpus.push_back(first);
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+// 读取 sysfs 中的单行文件（去掉行尾换行和空格），失败时返回 false
+inline bool read_sysfs_line(const char* path, std::string& line)
+{
+    FILE* f = std::fopen(path, "r");
+    if (!f)
+        return false;
+    char buf[1024] = { 0 };
+    bool ok = std::fgets(buf, sizeof(buf), f) != NULL;
+    std::fclose(f);
+    line = buf;
+    while (!line.empty() && (line[line.size() - 1] == '\n' || line[line.size() - 1] == ' '))
+        line.erase(line.size() - 1);
+    return ok;
+}
+
+struct Node
+{
+    int id;                 // sysfs 中的节点编号
+    std::vector<int> cpus;  // 逻辑核列表
+};
+
+// 在线且有 CPU 的节点（按编号递增）；读不到拓扑时视为编号 0、包含全部核的一个节点
+inline std::vector<Node> topology(int num_cpus)
+{
+    std::vector<Node> nodes;
+#if defined(__linux__)
+    // node/online 列出在线节点的编号（与 cpulist 格式相同），编号之间可以有空缺
+    std::string online;
+    if (read_sysfs_line("/sys/devices/system/node/online", online))
+    {
+        std::vector<int> ids = parse_cpulist(online);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            char path[96];
+            std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", ids[i]);
+            std::string line;
+            if (!read_sysfs_line(path, line))
+                continue;
+            Node node;
+            node.id = ids[i];
+            node.cpus = parse_cpulist(line);
+            if (!node.cpus.empty())
+                nodes.push_back(node);
+        }
+    }
+#endif
+    if (nodes.empty())
+    {
+        Node all;
+        all.id = 0;
+        for (int c = 0; c < num_cpus; ++c)
+            all.cpus.push_back(c);
+        nodes.push_back(all);
+    }
+    return nodes;
+}
+
+#if defined(__linux__)
+// linux/mempolicy.h 中的常量；避免依赖内核头文件版本
+const int MPOL_BIND_MODE = 2;
+const int MPOL_INTERLEAVE_MODE = 3;
+const unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+
+// node_ids 为节点编号（不要求连续），掩码的位数按最大编号确定
+inline bool mbind_range(void* ptr, size_t bytes, int mode, const std::vector<int>& node_ids)
+{
+    // 只作用于完全落在缓冲区内的整页，首尾不足一页的部分保持原策略
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = ((size_t)ptr + page - 1) & ~(page - 1);
+    size_t end = ((size_t)ptr + bytes) & ~(page - 1);
+    if (end <= begin)
+        return true;
+    const size_t word_bits = 8 * sizeof(unsigned long);
+    int max_id = 0;
+    for (size_t i = 0; i < node_ids.size(); ++i)
+        max_id = node_ids[i] > max_id ? node_ids[i] : max_id;
+    std::vector<unsigned long> mask(max_id / word_bits + 1, 0ul);
+    for (size_t i = 0; i < node_ids.size(); ++i)
+        mask[node_ids[i] / word_bits] |= 1ul << (node_ids[i] % word_bits);
+    // 内核先把 maxnode 减一再按位读取，多传一位才能用到最后一个字的最高位
+    long rc = syscall(SYS_mbind, (void*)begin, end - begin, mode, mask.data(),
+                      (unsigned long)(mask.size() * word_bits + 1), MPOL_MF_MOVE_FLAG);
+    return rc == 0;
+}
+#endif
+
+// 按策略放置 [ptr, ptr + bytes)；POLICY_FIRST_TOUCH 不做任何事。node 为 sysfs 中的节点编号
+inline bool place(void* ptr, size_t bytes, Policy policy, int node = 0)
+{
+#if defined(__linux__)
+    if (policy == POLICY_FIRST_TOUCH || bytes == 0)
+        return true;
+    std::vector<Node> nodes = topology(0);
+    if (nodes.size() <= 1)
+        return true;
+    std::vector<int> ids;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (policy == POLICY_INTERLEAVE || nodes[i].id == node)
+            ids.push_back(nodes[i].id);
+    }
+    if (ids.empty())
+        return false;
+    return mbind_range(ptr, bytes, policy == POLICY_INTERLEAVE ? MPOL_INTERLEAVE_MODE : MPOL_BIND_MODE, ids);
+#else
+    (void)ptr;
+    (void)bytes;
+    (void)policy;
+    (void)node;
+    return policy == POLICY_FIRST_TOUCH;
+#endif
+}
+
+// 命令行形式："first-touch" / "interleave" / "node<N>"
+inline bool parse_policy(const char* text, Policy& policy, int& node)
+{
+    node = 0;
+    if (std::strcmp(text, "first-touch") == 0)
+        policy = POLICY_FIRST_TOUCH;
+    else if (std::strcmp(text, "interleave") == 0)
+        policy = POLICY_INTERLEAVE;
+    else if (std::strncmp(text, "node", 4) == 0 && text[4] != '\0')
+    {
+        policy = POLICY_BIND;
+        node = std::atoi(text + 4);
+    }
+    else
+        return false;
+    return true;
+}
+
+inline const char* policy_name(Policy policy)
+{
+    switch (policy)
+    {
+    case POLICY_INTERLEAVE: return "interleave";
+    case POLICY_BIND: return "bind";
+    default: return "first-touch";
+    }
+}
+
+} // namespace numa
+
+#endif // COMMON_NUMA_H
@@ -0,0 +1,223 @@
+#ifndef COMMON_PERF_COUNTERS_H
+#define COMMON_PERF_COUNTERS_H
+
+// perf_event_open 的轻量封装：统计热点区域的 cycles、instructions、
+// LLC 访问/缺失和浮点运算指令数，用于判断内核是计算受限还是带宽受限。
+//
+// 用法：
+//   perfc::PerfCounters counters;          // 必须在第一个 OpenMP 并行区之前构造
+//   ...
+//   counters.start();  kernel();  counters.stop();   // 可多次累加
+//   counters.print_summary(std::cout, calls);        // 按调用次数平均后输出
+//
+// 计数器以 inherit 方式打开，之后创建的 OpenMP 工作线程也会被统计，
+// 因此构造要早于线程池创建。非 Linux 平台或没有权限时所有计数器显示 n/a。
+// FP_ARITH 默认使用 Intel 的 FP_ARITH_INST_RETIRED（event 0xC7，全部 umask），
+// 统计的是浮点指令数而不是 FLOP；其他 CPU 可用 PERF_FP_RAW=<十六进制 config> 覆盖。
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perfc {
+
+enum Counter
+{
+    CYCLES = 0,
+    INSTRUCTIONS,
+    LLC_REFERENCES,
+    LLC_MISSES,
+    FP_ARITH,
+    NUM_COUNTERS
+};
+
+inline const char* counter_name(int c)
+{
+    static const char* names[NUM_COUNTERS] = {
+        "cycles", "instructions", "llc_references", "llc_misses", "fp_arith_inst"
+    };
+    return names[c];
+}
+
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+        {
+            fd_[c] = -1;
+            begin_[c] = 0;
+            total_[c] = 0;
+        }
+#if defined(__linux__)
+        open_counter(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_counter(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_counter(LLC_REFERENCES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+        open_counter(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        uint64_t fp_config = 0xFFC7;
+        const char* fp_raw = std::getenv("PERF_FP_RAW");
+        if (fp_raw && fp_raw[0] != '\0')
+            fp_config = std::strtoull(fp_raw, NULL, 16);
+        open_counter(FP_ARITH, PERF_TYPE_RAW, fp_config);
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+        {
+            if (fd_[c] >= 0)
+                close(fd_[c]);
+        }
+#endif
+    }
+
+    bool available(int c) const { return fd_[c] >= 0; }
+
+    bool any_available() const
+    {
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+        {
+            if (available(c))
+                return true;
+        }
+        return false;
+    }
+
+    void start()
+    {
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+            begin_[c] = read_counter(c);
+    }
+
+    void stop()
+    {
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+            total_[c] += read_counter(c) - begin_[c];
+    }
+
+    void reset()
+    {
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+            total_[c] = 0;
+    }
+
+    uint64_t total(int c) const { return total_[c]; }
+
+    double ipc() const
+    {
+        if (!available(CYCLES) || !available(INSTRUCTIONS) || total_[CYCLES] == 0)
+            return 0.0;
+        return (double)total_[INSTRUCTIONS] / (double)total_[CYCLES];
+    }
+
+    double llc_miss_rate() const
+    {
+        if (!available(LLC_REFERENCES) || !available(LLC_MISSES) || total_[LLC_REFERENCES] == 0)
+            return 0.0;
+        return (double)total_[LLC_MISSES] / (double)total_[LLC_REFERENCES];
+    }
+
+    // 一行摘要，数值按 calls 次调用取平均
+    std::string summary(int calls) const
+    {
+        std::ostringstream os;
+        if (!any_available())
+        {
+            os << "Perf counters: n/a";
+            return os.str();
+        }
+        if (calls <= 0)
+            calls = 1;
+        os << std::fixed << std::setprecision(0);
+        os << "Perf counters (per call):";
+        for (int c = 0; c < NUM_COUNTERS; ++c)
+        {
+            os << " " << counter_name(c) << "=";
+            if (available(c))
+                os << (double)total_[c] / calls;
+            else
+                os << "n/a";
+        }
+        os << std::setprecision(2);
+        os << " IPC=";
+        if (available(CYCLES) && available(INSTRUCTIONS))
+            os << ipc();
+        else
+            os << "n/a";
+        os << " LLC_miss_rate=";
+        if (available(LLC_REFERENCES) && available(LLC_MISSES))
+            os << llc_miss_rate() * 100.0 << "%";
+        else
+            os << "n/a";
+        return os.str();
+    }
+
+    void print_summary(std::ostream& out, int calls) const
+    {
+        out << summary(calls) << std::endl;
+    }
+
+private:
+#if defined(__linux__)
+    void open_counter(int c, uint32_t type, uint64_t config)
+    {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_[c] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+
+    uint64_t read_counter(int c) const
+    {
+#if defined(__linux__)
+        uint64_t value = 0;
+        if (fd_[c] >= 0 && read(fd_[c], &value, sizeof(value)) == (ssize_t)sizeof(value))
+            return value;
+#else
+        (void)c;
+#endif
+        return 0;
+    }
+
+    int fd_[NUM_COUNTERS];
+    uint64_t begin_[NUM_COUNTERS];
+    uint64_t total_[NUM_COUNTERS];
+
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+};
+
+// RAII 区间：构造时 start，析构时 stop
+class ScopedCounting
+{
+public:
+    explicit ScopedCounting(PerfCounters& counters) : counters_(counters) { counters_.start(); }
+    ~ScopedCounting() { counters_.stop(); }
+
+private:
+    PerfCounters& counters_;
+};
+
+} // namespace perfc
+
+#endif // COMMON_PERF_COUNTERS_H
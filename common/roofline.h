@@ -0,0 +1,78 @@
+#ifndef COMMON_ROOFLINE_H
+#define COMMON_ROOFLINE_H
+
+// 带宽受限内核的 roofline 估计：用 STREAM triad 测出可达内存带宽，
+// 再按内核的算术强度（flop / byte）得到性能上限，和实测 GFLOP/s 对比。
+//
+// 用法：
+//   double bw = roofline::stream_triad_gbs(num_threads);       // 启动时测一次
+//   ... 计时内核 ...
+//   std::cout << roofline::summary(flops, bytes, seconds, bw);  // "Roofline: x GFLOP/s, y% of z ..."
+//
+// 只考虑内存带宽这一条屋顶线：Gauss-Seidel 之类模板内核的算术强度约 0.1 flop/byte，
+// 远低于任何 CPU 的脊点，浮点峰值不构成限制。bytes 由调用方按理想的流式访存量给出
+// （每次遍历读写整个数组一次），数据留在缓存中的实现可以超过 100%。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+namespace roofline
+{
+
+// STREAM triad a = b + s * c，取多次运行的最好结果，按 3 个数组的读写计字节数（不计 write-allocate）
+inline double stream_triad_gbs(int num_threads, size_t n = (size_t)1 << 22, int reps = 5)
+{
+    std::vector<double> a(n), b(n), c(n);
+    const double s = 3.0;
+
+    // 与计算相同的划分做 first-touch
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (long i = 0; i < (long)n; ++i)
+    {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    double best = 0.0;
+    for (int r = 0; r < reps; ++r)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for (long i = 0; i < (long)n; ++i)
+            a[i] = b[i] + s * c[i];
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double sec = std::chrono::duration<double>(end - start).count();
+        if (sec > 0.0)
+            best = std::max(best, 3.0 * sizeof(double) * n / sec * 1e-9);
+    }
+    return best;
+}
+
+// 带宽屋顶线给出的 GFLOP/s 上限
+inline double bound_gflops(double flops, double bytes, double bw_gbs)
+{
+    return bytes > 0.0 ? bw_gbs * flops / bytes : 0.0;
+}
+
+inline std::string summary(double flops, double bytes, double seconds, double bw_gbs)
+{
+    double gflops = seconds > 0.0 ? flops / seconds * 1e-9 : 0.0;
+    double bound = bound_gflops(flops, bytes, bw_gbs);
+    char buf[160];
+    std::snprintf(buf, sizeof(buf),
+                  "Roofline: %.2f GFLOP/s, %.1f%% of %.2f GFLOP/s bound (AI %.3f flop/B, %.1f GB/s)",
+                  gflops, bound > 0.0 ? 100.0 * gflops / bound : 0.0, bound,
+                  bytes > 0.0 ? flops / bytes : 0.0, bw_gbs);
+    return buf;
+}
+
+} // namespace roofline
+
+#endif // COMMON_ROOFLINE_H
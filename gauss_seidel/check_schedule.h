@@ -0,0 +1,80 @@
+#ifndef CHECK_SCHEDULE_H
+#define CHECK_SCHEDULE_H
+
+#include <algorithm>
+#include <cmath>
+
+// 收敛检查的自适应调度，Gauss-Seidel 各求解器共用
+//
+// 固定的检查间隔对小问题太稀（收敛后多做上百次迭代），对大问题又太密（每次检查是一次完整的网格遍历）。
+// 这里由最近两次检查的残差估计每次迭代的收敛因子 q = (r / r_prev)^(1 / Δiter)，
+// 预测还需要 k = log(tol / r) / log(q) 次迭代，下一次就在那时检查。
+// Gauss-Seidel 前期高频误差衰减快，估计的 q 偏乐观，预测偏早，只会多一两次检查而不会越过容差太多；
+// q 还不可用（第一次检查、残差没有下降）时间隔加倍。间隔每次最多放大 GROWTH 倍，防止残差暂时停滞后
+// q 接近 1、预测出极长的间隔。
+// 收敛时按同一个 q 倒推残差跨过 tol 的迭代，估计多做了多少次迭代（wasted）。
+
+struct CheckStats {
+    int checks;         // 残差计算次数
+    int wasted;         // 估计的多余迭代次数（残差已低于 tol 之后的迭代），没收敛或无法估计时为 0
+    double rate;        // 最后一次估计的每次迭代收敛因子，未知时为 0
+
+    CheckStats() : checks(0), wasted(0), rate(0.0) {}
+};
+
+class CheckSchedule {
+public:
+    static const int FIRST = 10;        // 第一次检查前的迭代次数
+    static const int GROWTH = 4;
+
+    CheckSchedule()
+        : next_(FIRST), interval_(FIRST), last_residual_(0.0), last_iter_(0) {}
+
+    // 下一次检查时已完成的迭代次数
+    int next_check() const { return next_; }
+
+    // 已完成 iter 次迭代时的残差，安排下一次检查
+    void update(double residual, int iter, double tol) {
+        ++stats_.checks;
+
+        double rate = 0.0;
+        if (last_iter_ > 0 && iter > last_iter_ && last_residual_ > 0.0 && residual > 0.0 &&
+            residual < last_residual_) {
+            rate = std::pow(residual / last_residual_, 1.0 / (iter - last_iter_));
+            rate = std::min(rate, 1.0 - 1e-12);
+            stats_.rate = rate;
+        }
+
+        if (residual < tol) {
+            if (rate > 0.0) {
+                // r = tol * q^w
+                double w = std::log(residual / tol) / std::log(rate);
+                stats_.wasted = std::min((int)w, iter - last_iter_ - 1);
+            }
+        } else {
+            int interval;
+            if (rate > 0.0) {
+                double k = std::ceil(std::log(tol / residual) / std::log(rate));
+                interval = (int)std::min(k, (double)GROWTH * interval_);
+            } else {
+                interval = 2 * interval_;
+            }
+            interval_ = std::max(interval, 1);
+            next_ = iter + interval_;
+        }
+
+        last_residual_ = residual;
+        last_iter_ = iter;
+    }
+
+    const CheckStats& stats() const { return stats_; }
+
+private:
+    int next_;
+    int interval_;
+    double last_residual_;
+    int last_iter_;
+    CheckStats stats_;
+};
+
+#endif // CHECK_SCHEDULE_H
@@ -1,4 +1,5 @@
 #include "gauss_seidel_2d.h"
+#include "sor.h"
 #include <cmath>
 #include <algorithm>
 #include <omp.h>
@@ -90,8 +91,8 @@ void GaussSeidel2D::solve_serial_redblack(
     }
 }
 
-// 并行红黑 Gauss-Seidel（修复小规模性能问题）
-void GaussSeidel2D::solve_parallel_redblack(
+// 串行 SOR（自然序）
+void GaussSeidel2D::solve_serial_sor(
     std::vector<double>& u,
     const std::vector<double>& f,
     int N,
@@ -100,109 +101,348 @@ void GaussSeidel2D::solve_parallel_redblack(
     double tol,
     int& iter_count,
     double& residual,
-    int num_threads
+    double omega
 ) {
     double h2 = h * h;
-    const double inv4 = 0.25;
-    omp_set_num_threads(num_threads);
+    SorEstimator estimator(sor_initial_omega(omega, h, false));
+    double w = estimator.omega();
+    bool estimating = omega < 0.0;
     
-    // 关键修复：根据规模和线程数自适应tile_size
-    // 目标：保证块数量 >> 线程数，才能有效并行
-    int tile_size;
+    for (int iter = 0; iter < max_iter; ++iter) {
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                double gs = 0.25 * (U(i-1, j) + U(i+1, j) + 
+                                    U(i, j-1) + U(i, j+1) + 
+                                    h2 * F(i-1, j-1));
+                U(i, j) += w * (gs - U(i, j));
+            }
+        }
+        
+        residual = compute_residual(u, f, N, h);
+        iter_count = iter + 1;
+        
+        if (residual < tol) {
+            break;
+        }
+        if (estimating && iter_count == estimator.next_sample()) {
+            estimator.update(residual, iter_count);
+            w = estimator.omega();
+            estimating = !estimator.done();
+        }
+    }
+}
+
+// 串行 SSOR：每次迭代先正序、再逆序各扫描一遍
+void GaussSeidel2D::solve_serial_ssor(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    double omega
+) {
+    double h2 = h * h;
+    // SSOR 的收敛因子与 ρ_J 没有 Young 关系，自适应模式直接用按 h 的值
+    double w = sor_initial_omega(omega, h, true);
+    
+    for (int iter = 0; iter < max_iter; ++iter) {
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                double gs = 0.25 * (U(i-1, j) + U(i+1, j) + 
+                                    U(i, j-1) + U(i, j+1) + 
+                                    h2 * F(i-1, j-1));
+                U(i, j) += w * (gs - U(i, j));
+            }
+        }
+        for (int i = N; i >= 1; --i) {
+            for (int j = N; j >= 1; --j) {
+                double gs = 0.25 * (U(i-1, j) + U(i+1, j) + 
+                                    U(i, j-1) + U(i, j+1) + 
+                                    h2 * F(i-1, j-1));
+                U(i, j) += w * (gs - U(i, j));
+            }
+        }
+        
+        residual = compute_residual(u, f, N, h);
+        iter_count = iter + 1;
+        
+        if (residual < tol) {
+            break;
+        }
+    }
+}
+
+// 并行红黑扫描的公共部分，solve_parallel_redblack 和 smooth_redblack（多重网格光滑器）共用
+namespace {
+
+// 关键修复：根据规模和线程数自适应tile_size
+// 目标：保证块数量 >> 线程数，才能有效并行
+int redblack_tile_size(int N, int num_threads) {
     if (N <= 64) {
         // 64: 需要至少16个块 (64/16=4, 4*4=16块)
-        tile_size = (num_threads >= 4) ? 16 : 32;
+        return (num_threads >= 4) ? 16 : 32;
     } else if (N <= 128) {
         // 128: 需要至少16-64个块
-        tile_size = (num_threads >= 8) ? 16 : 32;
+        return (num_threads >= 8) ? 16 : 32;
     } else if (N <= 256) {
-        tile_size = 32;  // 256/32=8, 8*8=64个块
+        return 32;  // 256/32=8, 8*8=64个块
     } else if (N <= 512) {
-        tile_size = 64;  // 512/64=8, 8*8=64个块
-    } else {
-        tile_size = 128; // 1024/128=8, 8*8=64个块
+        return 64;  // 512/64=8, 8*8=64个块
     }
+    return 128;     // 1024/128=8, 8*8=64个块
+}
+
+// 单色半次扫描：color = 0 更新红点 (i+j)%2==0，color = 1 更新黑点。
+// RELAX 为 true 时按松弛因子 omega 做 SOR 更新，false 时即 Gauss-Seidel（不读旧值，omega 忽略）。
+// TRACK 为 true 时返回本线程更新量的平方和 Σ(gs - u_old)²（Gauss-Seidel 更新前残差的 (h²/4)² 倍），否则返回 0。
+// 孤立的 omp for（nowait），必须在并行区内调用，调用方负责之后的 barrier
+template <bool RELAX, bool TRACK = false>
+double redblack_sweep_color(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h2,
+    int tile_size,
+    int color,
+    double omega
+) {
+    const double inv4 = 0.25;
+    double dsum = 0.0;
     
-    // 小规模问题更容易收敛，应该更频繁检查
-    // 大规模问题收敛慢，减少检查频率
-    int check_interval = 50;
-    if (N >= 512) {
-        check_interval = 200;  // 大规模问题减少检查
-    } else if (N >= 256) {
-        check_interval = 100;
+    // 使用简单的2D分块
+    #pragma omp for schedule(static) collapse(2) nowait
+    for (int bi = 1; bi <= N; bi += tile_size) {
+        for (int bj = 1; bj <= N; bj += tile_size) {
+            int i_end = std::min(bi + tile_size, N + 1);
+            int j_end = std::min(bj + tile_size, N + 1);
+            
+            // 块内更新本颜色的点
+            for (int i = bi; i < i_end; ++i) {
+                // 计算j起始位置，确保(i+j)%2==color
+                int j_start = bj + ((i + bj) % 2 == color ? 0 : 1);
+                for (int j = j_start; j < j_end; j += 2) {
+                    // 寄存器缓存
+                    double u_im = U(i-1, j);
+                    double u_ip = U(i+1, j);
+                    double u_jm = U(i, j-1);
+                    double u_jp = U(i, j+1);
+                    double f_val = h2 * F(i-1, j-1);
+                    double gs = inv4 * (u_im + u_ip + u_jm + u_jp + f_val);
+                    
+                    if (TRACK) {
+                        double delta = gs - U(i, j);
+                        dsum += delta * delta;
+                    }
+                    
+                    if (RELAX) {
+                        U(i, j) += omega * (gs - U(i, j));
+                    } else {
+                        U(i, j) = gs;
+                    }
+                }
+            }
+        }
     }
     
+    return dsum;
+}
+
+} // namespace
+
+// 并行红黑 Gauss-Seidel（修复小规模性能问题）
+void GaussSeidel2D::solve_parallel_redblack(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    CheckStats* stats
+) {
+    double h2 = h * h;
+    omp_set_num_threads(num_threads);
+    
+    int tile_size = redblack_tile_size(N, num_threads);
+    
+    // 检查时机由残差下降速度预测，代替按 N 取的固定间隔
+    CheckSchedule schedule;
+    
     iter_count = 0;
     
     #pragma omp parallel num_threads(num_threads)
     {
-        // 线程局部变量
-        double local_h2 = h2;
-        double local_inv4 = inv4;
-        
         for (int iter = 0; iter < max_iter; ++iter) {
             
-            // 红点更新 - 使用简单的2D分块
-            #pragma omp for schedule(static) collapse(2) nowait
-            for (int bi = 1; bi <= N; bi += tile_size) {
-                for (int bj = 1; bj <= N; bj += tile_size) {
-                    int i_end = std::min(bi + tile_size, N + 1);
-                    int j_end = std::min(bj + tile_size, N + 1);
-                    
-                    // 块内更新红点
-                    for (int i = bi; i < i_end; ++i) {
-                        // 计算j起始位置，确保(i+j)%2==0
-                        int j_start = bj + ((i + bj) % 2 == 0 ? 0 : 1);
-                        for (int j = j_start; j < j_end; j += 2) {
-                            // 寄存器缓存
-                            double u_im = U(i-1, j);
-                            double u_ip = U(i+1, j);
-                            double u_jm = U(i, j-1);
-                            double u_jp = U(i, j+1);
-                            double f_val = local_h2 * F(i-1, j-1);
-                            
-                            U(i, j) = local_inv4 * (u_im + u_ip + u_jm + u_jp + f_val);
-                        }
-                    }
-                }
-            }
+            // 红点更新
+            redblack_sweep_color<false>(u, f, N, h2, tile_size, 0, 1.0);
             
             #pragma omp barrier
             
             // 黑点更新
-            #pragma omp for schedule(static) collapse(2) nowait
-            for (int bi = 1; bi <= N; bi += tile_size) {
-                for (int bj = 1; bj <= N; bj += tile_size) {
-                    int i_end = std::min(bi + tile_size, N + 1);
-                    int j_end = std::min(bj + tile_size, N + 1);
-                    
-                    // 块内更新黑点
-                    for (int i = bi; i < i_end; ++i) {
-                        // 计算j起始位置，确保(i+j)%2==1
-                        int j_start = bj + ((i + bj) % 2 == 1 ? 0 : 1);
-                        for (int j = j_start; j < j_end; j += 2) {
-                            double u_im = U(i-1, j);
-                            double u_ip = U(i+1, j);
-                            double u_jm = U(i, j-1);
-                            double u_jp = U(i, j+1);
-                            double f_val = local_h2 * F(i-1, j-1);
-                            
-                            U(i, j) = local_inv4 * (u_im + u_ip + u_jm + u_jp + f_val);
-                        }
+            redblack_sweep_color<false>(u, f, N, h2, tile_size, 1, 1.0);
+            
+            // schedule 只在下面的 single 中修改，必须在 barrier 之前读取，
+            // 否则先进入 single 的线程改掉 next_check 后，其余线程会跳过 single 而死锁
+            const int next_check = schedule.next_check();
+            
+            #pragma omp barrier
+            
+            // 收敛检查
+            if (iter + 1 == next_check) {
+                #pragma omp single
+                {
+                    residual = compute_residual(u, f, N, h);
+                    schedule.update(residual, iter + 1, tol);
+                    if (residual < tol) {
+                        iter_count = iter + 1;
+                        max_iter = iter;
                     }
                 }
             }
+        }
+    }
+    
+    if (iter_count == 0) {
+        residual = compute_residual(u, f, N, h);
+        iter_count = max_iter;
+    }
+    if (stats) {
+        *stats = schedule.stats();
+    }
+}
+
+// 并行红黑 Gauss-Seidel，残差在黑点扫描中顺带累计，每次迭代都检查收敛。
+// 红点扫描之后红点的残差为 0，黑点的残差为 4 (gs - u_old) / h²，所以黑点扫描时累计的 Σ(gs - u_old)²
+// 给出的恰好是红点扫描之后那个中间状态的残差范数（相差半次迭代），不需要额外遍历网格。
+// 每个线程的部分和独占一条缓存行；barrier 之后每个线程按相同顺序求和并各自判定，结果一致，不需要 single。
+// 返回的 residual 在结束时按 compute_residual 重新计算一次
+void GaussSeidel2D::solve_parallel_redblack_fused(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads
+) {
+    double h2 = h * h;
+    int tile_size = redblack_tile_size(N, num_threads);
+    
+    const int PAD = 8;  // 64 字节 / sizeof(double)
+    std::vector<double> partial((size_t)num_threads * PAD, 0.0);
+    const double scale = 4.0 / h2;
+    
+    iter_count = max_iter;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        const int tid = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        
+        for (int iter = 0; iter < max_iter; ++iter) {
+            
+            // 红点更新
+            redblack_sweep_color<false>(u, f, N, h2, tile_size, 0, 1.0);
             
             #pragma omp barrier
             
-            // 收敛检查
-            if (iter % check_interval == check_interval - 1) {
+            // 黑点更新，同时累计本线程的部分和
+            partial[tid * PAD] = redblack_sweep_color<false, true>(u, f, N, h2, tile_size, 1, 1.0);
+            
+            #pragma omp barrier
+            
+            // 下一次写 partial 在下一个红点扫描的 barrier 之后，这里读取不会和写冲突
+            double sum = 0.0;
+            for (int t = 0; t < nt; ++t) {
+                sum += partial[t * PAD];
+            }
+            if (scale * std::sqrt(sum) < tol) {
+                #pragma omp master
+                iter_count = iter + 1;
+                break;
+            }
+        }
+    }
+    
+    residual = compute_residual(u, f, N, h);
+}
+
+// 并行红黑 SOR：与 solve_parallel_redblack 相同的分块和同步方式，每个点按 ω 松弛。
+// 自适应估计期间按 SorEstimator 的采样窗口检查残差，之后（或 ω 给定时）由 CheckSchedule 安排检查
+void GaussSeidel2D::solve_parallel_redblack_sor(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    double omega,
+    CheckStats* stats
+) {
+    double h2 = h * h;
+    int tile_size = redblack_tile_size(N, num_threads);
+    
+    SorEstimator estimator(sor_initial_omega(omega, h, false));
+    double w = estimator.omega();
+    bool estimating = omega < 0.0;
+    
+    // ω 固定之后收敛因子才有意义，schedule 从那次迭代（check_base）开始计数
+    CheckSchedule schedule;
+    int check_base = 0;
+    int estimate_checks = 0;
+    
+    iter_count = 0;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int iter = 0; iter < max_iter; ++iter) {
+            redblack_sweep_color<true>(u, f, N, h2, tile_size, 0, w);
+            
+            #pragma omp barrier
+            
+            redblack_sweep_color<true>(u, f, N, h2, tile_size, 1, w);
+            
+            // estimating / estimator / check_base / schedule 只在下面的 single 中修改，必须在 barrier 之前读取，
+            // 否则先进入 single 的线程改掉它们后，其余线程按另一个时机判断、跳过 single 而死锁
+            bool check;
+            if (estimating) {
+                check = iter + 1 == estimator.next_sample();
+            } else {
+                check = iter + 1 - check_base == schedule.next_check();
+            }
+            
+            #pragma omp barrier
+            
+            if (check) {
                 #pragma omp single
                 {
                     residual = compute_residual(u, f, N, h);
+                    if (estimating) {
+                        ++estimate_checks;
+                    } else {
+                        schedule.update(residual, iter + 1 - check_base, tol);
+                    }
                     if (residual < tol) {
                         iter_count = iter + 1;
                         max_iter = iter;
+                    } else if (estimating) {
+                        estimator.update(residual, iter + 1);
+                        w = estimator.omega();
+                        if (estimator.done()) {
+                            estimating = false;
+                            check_base = iter + 1;
+                        }
                     }
                 }
             }
@@ -213,6 +453,55 @@ void GaussSeidel2D::solve_parallel_redblack(
         residual = compute_residual(u, f, N, h);
         iter_count = max_iter;
     }
+    if (stats) {
+        *stats = schedule.stats();
+        stats->checks += estimate_checks;
+    }
+}
+
+// 固定次数的并行红黑扫描，不做收敛检查（多重网格光滑器）
+void GaussSeidel2D::smooth_redblack(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int sweeps,
+    int num_threads
+) {
+    double h2 = h * h;
+    int tile_size = redblack_tile_size(N, num_threads);
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int s = 0; s < sweeps; ++s) {
+            redblack_sweep_color<false>(u, f, N, h2, tile_size, 0, 1.0);
+            #pragma omp barrier
+            redblack_sweep_color<false>(u, f, N, h2, tile_size, 1, 1.0);
+            #pragma omp barrier
+        }
+    }
+}
+
+// 对称红黑扫描：红、黑、红。红黑序的对称 Gauss-Seidel（正向 红→黑，反向 黑→红）中
+// 连续两次黑点扫描结果相同，合并后即为三次半扫描；u 初值为 0 时对应对称正定的预条件矩阵
+void GaussSeidel2D::symmetric_sweep_redblack(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int num_threads
+) {
+    double h2 = h * h;
+    int tile_size = redblack_tile_size(N, num_threads);
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        redblack_sweep_color<false>(u, f, N, h2, tile_size, 0, 1.0);
+        #pragma omp barrier
+        redblack_sweep_color<false>(u, f, N, h2, tile_size, 1, 1.0);
+        #pragma omp barrier
+        redblack_sweep_color<false>(u, f, N, h2, tile_size, 0, 1.0);
+    }
 }
 
 // 计算残差范数（L2范数）
@@ -22,7 +22,8 @@ void solve_4level_tiling(
     double tol,
     int& iter_count,
     double& residual,
-    int num_threads
+    int num_threads,
+    CheckStats* stats
 ) {
     double h2 = h * h;
     omp_set_num_threads(num_threads);
@@ -33,7 +34,7 @@ void solve_4level_tiling(
     const int L3_TILE = (N >= 512) ? 128 : 64;
     const int L1_TILE = 16;
     
-    const int check_interval = (N < 256) ? 200 : 100;
+    CheckSchedule schedule;
     iter_count = 0;
     
     #pragma omp parallel num_threads(num_threads) firstprivate(h2)
@@ -105,13 +106,17 @@ void solve_4level_tiling(
                 }
             }
             
+            //  barrier ֮ǰȡsingle ޸ schedule Ӱ̵߳ж
+            const int next_check = schedule.next_check();
+            
             #pragma omp barrier
             
             // 
-            if (iter % check_interval == check_interval - 1) {
+            if (iter + 1 == next_check) {
                 #pragma omp single
                 {
                     residual = GaussSeidel2D::compute_residual(u, f, N, h);
+                    schedule.update(residual, iter + 1, tol);
                     if (residual < tol) {
                         iter_count = iter + 1;
                         max_iter = iter;
@@ -125,6 +130,151 @@ void solve_4level_tiling(
         residual = GaussSeidel2D::compute_residual(u, f, N, h);
         iter_count = max_iter;
     }
+    if (stats) {
+        *stats = schedule.stats();
+    }
+}
+
+// ========== ʱֿ飨temporal blocking ==========
+// ͨڵÿɨ趼Ҫ uf ڴһ飻N >= 512 ʱŲ棬
+// ÿε DRAMǴ޵ġ T ε2T ɨ裬 s 
+// ɨżΪ㡢Ϊڵ㣩ϲһαһݽ뻺ɨ裺
+//
+// ɨ s ڵ i ֻɨ s-1  i-1ii+1 еĽ
+//   wavefront r ðɨ s  r - s Уs С󣬰ɨ s-1 һУ
+//             Ծֻ 2T + 2 У L1/L2 
+//   ѷֿ飺аг߳ͬ
+//     ׶ 1Уÿڰɨ s ֻ [a + s, b - s)ھд
+//     ׶ 2Уÿڲ߽ b  [b - s, b + s) 
+//   ׶֮һϣȡԭÿɨһϡ
+// ÿļ˳Ͳͨڵȫͬλһ¡
+
+//  i ɫΪ color ĵ㣺(i + j) % 2 == color
+static inline void update_row_color(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h2,
+    int i,
+    int color
+) {
+    int j_start = ((i + 1) % 2 == color) ? 1 : 2;
+    for (int j = j_start; j <= N; j += 2) {
+        U(i, j) = 0.25 * (U(i-1, j) + U(i+1, j) + U(i, j-1) + U(i, j+1) + h2 * F(i-1, j-1));
+    }
+}
+
+//  wavefront ˳ִ stages ɨ裬ɨ s  [lo0 + s*dlo, hi0 + s*dhi)
+static void wavefront_rows(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h2,
+    int lo0, int dlo,
+    int hi0, int dhi,
+    int stages
+) {
+    int r_begin = lo0;
+    int r_end = hi0;
+    for (int s = 0; s < stages; ++s) {
+        r_begin = std::min(r_begin, lo0 + s * dlo + s);
+        r_end = std::max(r_end, hi0 + s * dhi + s);
+    }
+    
+    for (int r = r_begin; r < r_end; ++r) {
+        for (int s = 0; s < stages; ++s) {
+            int i = r - s;
+            if (i >= lo0 + s * dlo && i < hi0 + s * dhi) {
+                update_row_color(u, f, N, h2, i, s % 2);
+            }
+        }
+    }
+}
+
+// ʱֿ鲢кGauss-Seidelÿα time_block ε0 ΪĬֵ 4
+void solve_temporal_tiling(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    int time_block,
+    CheckStats* stats
+) {
+    double h2 = h * h;
+    
+    // ߶Ϊ 4T 2T У̫СʱȼС Tټ
+    int T = (time_block > 0) ? time_block : 4;
+    int slabs = std::max(1, num_threads);
+    if (slabs > 1 && N / slabs < 4 * T) {
+        T = std::max(1, N / (4 * slabs));
+    }
+    if (N / slabs < 4 * T) {
+        slabs = std::max(1, N / (4 * T));
+    }
+    std::vector<int> edge(slabs + 1);
+    for (int k = 0; k <= slabs; ++k) {
+        edge[k] = 1 + (int)((long)N * k / slabs);
+    }
+    
+    CheckSchedule schedule;
+    iter_count = 0;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int iter = 0; iter < max_iter; ) {
+            // һԤļضϣschedule ֻڱαĩβ single ޸ģĶȡ֮ǰ
+            const int check_at = schedule.next_check();
+            int steps = std::min(T, max_iter - iter);
+            if (check_at > iter) {
+                steps = std::min(steps, check_at - iter);
+            }
+            int stages = 2 * steps;
+            
+            // ׶ 1Σ߽һ಻
+            #pragma omp for schedule(static)
+            for (int k = 0; k < slabs; ++k) {
+                int a = edge[k];
+                int b = edge[k + 1];
+                wavefront_rows(u, f, N, h2,
+                               a, (a == 1) ? 0 : 1,
+                               b, (b == N + 1) ? 0 : -1,
+                               stages);
+            }
+            
+            // ׶ 2ڲ߽紦ŵ
+            #pragma omp for schedule(static)
+            for (int k = 1; k < slabs; ++k) {
+                wavefront_rows(u, f, N, h2, edge[k], -1, edge[k], 1, stages);
+            }
+            
+            int next = iter + steps;
+            if (next >= check_at) {
+                #pragma omp single
+                {
+                    residual = GaussSeidel2D::compute_residual(u, f, N, h);
+                    schedule.update(residual, next, tol);
+                    if (residual < tol) {
+                        iter_count = next;
+                        max_iter = next;
+                    }
+                }
+            }
+            iter = next;
+        }
+    }
+    
+    if (iter_count == 0) {
+        residual = GaussSeidel2D::compute_residual(u, f, N, h);
+        iter_count = max_iter;
+    }
+    if (stats) {
+        *stats = schedule.stats();
+    }
 }
 
 } // namespace GaussSeidel2DTiled
@@ -1,4 +1,5 @@
 #include "gauss_seidel_2d.h"
+#include "stencil_simd.h"
 #include <cmath>
 #include <algorithm>
 #include <omp.h>
@@ -62,7 +63,8 @@ void solve_4level_tiling_aligned(
     double tol,
     int& iter_count,
     double& residual,
-    int num_threads
+    int num_threads,
+    CheckStats* stats
 ) {
     double h2 = h * h;
     omp_set_num_threads(num_threads);
@@ -93,7 +95,7 @@ void solve_4level_tiling_aligned(
         L1_tile = 64;
     }
     
-    int check_interval = (N >= 128) ? 500 : 100;
+    CheckSchedule schedule;
     iter_count = 0;
     
     #pragma omp parallel num_threads(num_threads)
@@ -115,15 +117,8 @@ void solve_4level_tiling_aligned(
                             int tj_end = std::min(tile_j + L1_tile, j_end);
                             
                             for (int i = tile_i; i < ti_end; ++i) {
-                                for (int j = tile_j + ((i + tile_j) % 2); j < tj_end; j += 2) {
-                                    double u_im = U(i-1, j);
-                                    double u_ip = U(i+1, j);
-                                    double u_jm = U(i, j-1);
-                                    double u_jp = U(i, j+1);
-                                    double f_val = local_h2 * F(i-1, j-1);
-                                    
-                                    U(i, j) = 0.25 * (u_im + u_ip + u_jm + u_jp + f_val);
-                                }
+                                stencil_rb_row_2d(&U(i, 0), &U(i-1, 0), &U(i+1, 0), &F(i-1, 0),
+                                                  local_h2, tile_j, tj_end, i % 2);
                             }
                         }
                     }
@@ -145,27 +140,24 @@ void solve_4level_tiling_aligned(
                             int tj_end = std::min(tile_j + L1_tile, j_end);
                             
                             for (int i = tile_i; i < ti_end; ++i) {
-                                for (int j = tile_j + ((i + tile_j + 1) % 2); j < tj_end; j += 2) {
-                                    double u_im = U(i-1, j);
-                                    double u_ip = U(i+1, j);
-                                    double u_jm = U(i, j-1);
-                                    double u_jp = U(i, j+1);
-                                    double f_val = local_h2 * F(i-1, j-1);
-                                    
-                                    U(i, j) = 0.25 * (u_im + u_ip + u_jm + u_jp + f_val);
-                                }
+                                stencil_rb_row_2d(&U(i, 0), &U(i-1, 0), &U(i+1, 0), &F(i-1, 0),
+                                                  local_h2, tile_j, tj_end, (i + 1) % 2);
                             }
                         }
                     }
                 }
             }
             
+            //  barrier ֮ǰȡsingle ޸ schedule Ӱ̵߳ж
+            const int next_check = schedule.next_check();
+            
             #pragma omp barrier
             
-            if (iter % check_interval == check_interval - 1) {
+            if (iter + 1 == next_check) {
                 #pragma omp single
                 {
                     residual = compute_residual_aligned(u, f, N, h);
+                    schedule.update(residual, iter + 1, tol);
                     iter_count = iter + 1;
                 }
                 
@@ -177,13 +169,17 @@ void solve_4level_tiling_aligned(
         
         #pragma omp single
         {
-            if (iter_count == 0 || iter_count % check_interval != 0) {
+            if (iter_count == 0 || !(residual < tol)) {
                 residual = compute_residual_aligned(u, f, N, h);
                 iter_count = max_iter;
             }
         }
     }
     
+    if (stats) {
+        *stats = schedule.stats();
+    }
+    
     // vector
     std::copy(u, u + u_vec.size(), u_vec.begin());
 }
@@ -202,7 +198,7 @@ double compute_residual_aligned(
     for (int i = 1; i <= N; ++i) {
         for (int j = 1; j <= N; ++j) {
             double laplacian = (U(i-1,j) + U(i+1,j) + U(i,j-1) + U(i,j+1) - 4.0*U(i,j)) / h2;
-            double diff = laplacian - F(i-1, j-1);
+            double diff = F(i-1, j-1) + laplacian;
             res += diff * diff;
         }
     }
@@ -2,6 +2,7 @@
 #define GAUSS_SEIDEL_3D_H
 
 #include <vector>
+#include "check_schedule.h"
 
 // 三维泊松方程求解器
 // 求解 -Δu = f，边界条件 u = 0
@@ -32,7 +33,33 @@ public:
         double& residual
     );
 
-    // 并行红黑 Gauss-Seidel（基于区域分解）
+    // 串行 SOR（自然序）。omega > 0 固定；0 取模型问题最优值 2/(1+sin(πh))；< 0 从该值开始、由残差历史判断偏小时提高（见 sor.h）
+    static void solve_serial_sor(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        double omega = 0.0
+    );
+
+    // 串行 SSOR（正序 + 逆序对称扫描），omega 约定同上（< 0 与 0 相同，见 sor.h）
+    static void solve_serial_ssor(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        double omega = 0.0
+    );
+
+    // 并行红黑 Gauss-Seidel（基于区域分解），收敛检查由 CheckSchedule 按残差下降速度安排
     static void solve_parallel_redblack(
         std::vector<double>& u,
         const std::vector<double>& f,
@@ -42,7 +69,55 @@ public:
         double tol,
         int& iter_count,
         double& residual,
-        int num_threads = 8          // OpenMP线程数
+        int num_threads = 8,         // OpenMP线程数
+        CheckStats* stats = nullptr  // 非空时返回检查次数和估计的多余迭代
+    );
+
+    // 并行红黑 Gauss-Seidel，残差在黑点扫描中按线程部分和累计，每次迭代检查收敛，不单独遍历网格
+    static void solve_parallel_redblack_fused(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 8
+    );
+
+    // 并行红黑 SOR，omega 约定同 solve_serial_sor
+    static void solve_parallel_redblack_sor(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 8,
+        double omega = 0.0,
+        CheckStats* stats = nullptr
+    );
+
+    // 固定次数的并行红黑扫描，不计算残差（多重网格光滑器）
+    static void smooth_redblack(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int sweeps,
+        int num_threads = 8
+    );
+
+    // 一次对称红黑扫描（红、黑、红），不计算残差（PCG 预条件子）
+    static void symmetric_sweep_redblack(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int num_threads = 8
     );
 
     // 计算残差范数
@@ -22,7 +22,8 @@ void solve_4level_tiling(
     double tol,
     int& iter_count,
     double& residual,
-    int num_threads
+    int num_threads,
+    CheckStats* stats
 ) {
     double h2 = h * h;
     const double inv6 = 1.0 / 6.0;  // Ԥ㳣
@@ -52,11 +53,8 @@ void solve_4level_tiling(
         TILE_SIZE = 128;  // 512^3: (512/128)^3 = 64
     }
     
-    // check_intervalٲвͬ
-    int check_interval = 100;
-    if (N >= 128) {
-        check_interval = 500;  // ģټƵ
-    }
+    // ʱв½ٶԤ⣨check_schedule.hԶʱټ
+    CheckSchedule schedule;
     
     iter_count = 0;
     
@@ -136,13 +134,16 @@ void solve_4level_tiling(
                 }
             }
             
+            //  barrier ֮ǰȡsingle ޸ schedule Ӱ̵߳ж
+            const int next_check = schedule.next_check();
+            
             #pragma omp barrier
             
-            // ٲвƵ
-            if (iter % check_interval == check_interval - 1) {
+            if (iter + 1 == next_check) {
                 #pragma omp single
                 {
                     residual = GaussSeidel3D::compute_residual(u, f, N, h);
+                    schedule.update(residual, iter + 1, tol);
                     if (residual < tol) {
                         iter_count = iter + 1;
                         max_iter = iter;
@@ -156,6 +157,155 @@ void solve_4level_tiling(
         residual = GaussSeidel3D::compute_residual(u, f, N, h);
         iter_count = max_iter;
     }
+    if (stats) {
+        *stats = schedule.stats();
+    }
+}
+
+// ========== ʱֿ飨temporal blocking ==========
+//  2D 汾ͬ gauss_seidel_2d_tiled.cpp i ƽ wavefront + ѷֿ飬
+// ÿα T εͨڵλһ¡
+// ԾΪ 2T + 2  (N+2)^2 ƽ棬N = 256 ʱԼ 10 MBT = 4 L2/L3 У
+// N ʱƽ汾棬½ʱӦС time_block
+
+//  i ƽɫΪ color ĵ㣺(i + j + k) % 2 == color
+static inline void update_plane_color(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h2,
+    int i,
+    int color
+) {
+    const double inv6 = 1.0 / 6.0;
+    for (int j = 1; j <= N; ++j) {
+        int k_start = ((i + j + 1) % 2 == color) ? 1 : 2;
+        for (int k = k_start; k <= N; k += 2) {
+            double u_im = U(i-1, j, k);
+            double u_ip = U(i+1, j, k);
+            double u_jm = U(i, j-1, k);
+            double u_jp = U(i, j+1, k);
+            double u_km = U(i, j, k-1);
+            double u_kp = U(i, j, k+1);
+            double f_val = h2 * F(i-1, j-1, k-1);
+            
+            U(i, j, k) = inv6 * (u_im + u_ip + u_jm + u_jp + u_km + u_kp + f_val);
+        }
+    }
+}
+
+//  wavefront ˳ִ stages ɨ裬ɨ s ƽ [lo0 + s*dlo, hi0 + s*dhi)
+static void wavefront_planes(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h2,
+    int lo0, int dlo,
+    int hi0, int dhi,
+    int stages
+) {
+    int r_begin = lo0;
+    int r_end = hi0;
+    for (int s = 0; s < stages; ++s) {
+        r_begin = std::min(r_begin, lo0 + s * dlo + s);
+        r_end = std::max(r_end, hi0 + s * dhi + s);
+    }
+    
+    for (int r = r_begin; r < r_end; ++r) {
+        for (int s = 0; s < stages; ++s) {
+            int i = r - s;
+            if (i >= lo0 + s * dlo && i < hi0 + s * dhi) {
+                update_plane_color(u, f, N, h2, i, s % 2);
+            }
+        }
+    }
+}
+
+// ʱֿ鲢кGauss-Seidel (3D汾)ÿα time_block ε0 ΪĬֵ 4
+void solve_temporal_tiling(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    int time_block,
+    CheckStats* stats
+) {
+    double h2 = h * h;
+    
+    // Ϊ 4T ƽ棬̫СʱȼС Tټ
+    int T = (time_block > 0) ? time_block : 4;
+    int slabs = std::max(1, num_threads);
+    if (slabs > 1 && N / slabs < 4 * T) {
+        T = std::max(1, N / (4 * slabs));
+    }
+    if (N / slabs < 4 * T) {
+        slabs = std::max(1, N / (4 * T));
+    }
+    std::vector<int> edge(slabs + 1);
+    for (int k = 0; k <= slabs; ++k) {
+        edge[k] = 1 + (int)((long)N * k / slabs);
+    }
+    
+    CheckSchedule schedule;
+    
+    iter_count = 0;
+    
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int iter = 0; iter < max_iter; ) {
+            // һԤļضϣschedule ֻڱαĩβ single ޸ģĶȡ֮ǰ
+            const int check_at = schedule.next_check();
+            int steps = std::min(T, max_iter - iter);
+            if (check_at > iter) {
+                steps = std::min(steps, check_at - iter);
+            }
+            int stages = 2 * steps;
+            
+            // ׶ 1Σ߽һ಻
+            #pragma omp for schedule(static)
+            for (int b = 0; b < slabs; ++b) {
+                int lo = edge[b];
+                int hi = edge[b + 1];
+                wavefront_planes(u, f, N, h2,
+                                 lo, (lo == 1) ? 0 : 1,
+                                 hi, (hi == N + 1) ? 0 : -1,
+                                 stages);
+            }
+            
+            // ׶ 2ڲ߽紦ŵ
+            #pragma omp for schedule(static)
+            for (int b = 1; b < slabs; ++b) {
+                wavefront_planes(u, f, N, h2, edge[b], -1, edge[b], 1, stages);
+            }
+            
+            int next = iter + steps;
+            if (next >= check_at) {
+                #pragma omp single
+                {
+                    residual = GaussSeidel3D::compute_residual(u, f, N, h);
+                    schedule.update(residual, next, tol);
+                    if (residual < tol) {
+                        iter_count = next;
+                        max_iter = next;
+                    }
+                }
+            }
+            iter = next;
+        }
+    }
+    
+    if (iter_count == 0) {
+        residual = GaussSeidel3D::compute_residual(u, f, N, h);
+        iter_count = max_iter;
+    }
+    if (stats) {
+        *stats = schedule.stats();
+    }
 }
 
 } // namespace GaussSeidel3DTiled
@@ -1,4 +1,5 @@
 #include "gauss_seidel_3d.h"
+#include "stencil_simd.h"
 #include <cmath>
 #include <algorithm>
 #include <omp.h>
@@ -62,7 +63,8 @@ void solve_4level_tiling_aligned(
     double tol,
     int& iter_count,
     double& residual,
-    int num_threads
+    int num_threads,
+    CheckStats* stats
 ) {
     double h2 = h * h;
     omp_set_num_threads(num_threads);
@@ -93,7 +95,7 @@ void solve_4level_tiling_aligned(
         L1_tile = 32;
     }
     
-    int check_interval = (N >= 64) ? 500 : 100;
+    CheckSchedule schedule;
     iter_count = 0;
     
     #pragma omp parallel num_threads(num_threads)
@@ -120,17 +122,9 @@ void solve_4level_tiling_aligned(
                                     
                                     for (int i = tile_i; i < ti_end; ++i) {
                                         for (int j = tile_j; j < tj_end; ++j) {
-                                            for (int k = tile_k + ((i + j + tile_k) % 2); k < tk_end; k += 2) {
-                                                double u_im = U(i-1, j, k);
-                                                double u_ip = U(i+1, j, k);
-                                                double u_jm = U(i, j-1, k);
-                                                double u_jp = U(i, j+1, k);
-                                                double u_km = U(i, j, k-1);
-                                                double u_kp = U(i, j, k+1);
-                                                double f_val = local_h2 * F(i-1, j-1, k-1);
-                                                
-                                                U(i, j, k) = (u_im + u_ip + u_jm + u_jp + u_km + u_kp + f_val) / 6.0;
-                                            }
+                                            stencil_rb_row_3d(&U(i, j, 0), &U(i-1, j, 0), &U(i+1, j, 0),
+                                                              &U(i, j-1, 0), &U(i, j+1, 0), &F(i-1, j-1, 0),
+                                                              local_h2, tile_k, tk_end, (i + j) % 2);
                                         }
                                     }
                                 }
@@ -160,17 +154,9 @@ void solve_4level_tiling_aligned(
                                     
                                     for (int i = tile_i; i < ti_end; ++i) {
                                         for (int j = tile_j; j < tj_end; ++j) {
-                                            for (int k = tile_k + ((i + j + tile_k + 1) % 2); k < tk_end; k += 2) {
-                                                double u_im = U(i-1, j, k);
-                                                double u_ip = U(i+1, j, k);
-                                                double u_jm = U(i, j-1, k);
-                                                double u_jp = U(i, j+1, k);
-                                                double u_km = U(i, j, k-1);
-                                                double u_kp = U(i, j, k+1);
-                                                double f_val = local_h2 * F(i-1, j-1, k-1);
-                                                
-                                                U(i, j, k) = (u_im + u_ip + u_jm + u_jp + u_km + u_kp + f_val) / 6.0;
-                                            }
+                                            stencil_rb_row_3d(&U(i, j, 0), &U(i-1, j, 0), &U(i+1, j, 0),
+                                                              &U(i, j-1, 0), &U(i, j+1, 0), &F(i-1, j-1, 0),
+                                                              local_h2, tile_k, tk_end, (i + j + 1) % 2);
                                         }
                                     }
                                 }
@@ -180,12 +166,16 @@ void solve_4level_tiling_aligned(
                 }
             }
             
+            //  barrier ֮ǰȡsingle ޸ schedule Ӱ̵߳ж
+            const int next_check = schedule.next_check();
+            
             #pragma omp barrier
             
-            if (iter % check_interval == check_interval - 1) {
+            if (iter + 1 == next_check) {
                 #pragma omp single
                 {
                     residual = compute_residual_aligned(u, f, N, h);
+                    schedule.update(residual, iter + 1, tol);
                     iter_count = iter + 1;
                 }
                 
@@ -197,13 +187,17 @@ void solve_4level_tiling_aligned(
         
         #pragma omp single
         {
-            if (iter_count == 0 || iter_count % check_interval != 0) {
+            if (iter_count == 0 || !(residual < tol)) {
                 residual = compute_residual_aligned(u, f, N, h);
                 iter_count = max_iter;
             }
         }
     }
     
+    if (stats) {
+        *stats = schedule.stats();
+    }
+    
     // vector
     std::copy(u, u + u_vec.size(), u_vec.begin());
 }
@@ -224,7 +218,7 @@ double compute_residual_aligned(
             for (int k = 1; k <= N; ++k) {
                 double laplacian = (U(i-1,j,k) + U(i+1,j,k) + U(i,j-1,k) + U(i,j+1,k) + 
                                    U(i,j,k-1) + U(i,j,k+1) - 6.0*U(i,j,k)) / h2;
-                double diff = laplacian - F(i-1, j-1, k-1);
+                double diff = F(i-1, j-1, k-1) + laplacian;
                 res += diff * diff;
             }
         }
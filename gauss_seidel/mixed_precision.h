@@ -0,0 +1,52 @@
+#ifndef MIXED_PRECISION_H
+#define MIXED_PRECISION_H
+
+#include <vector>
+#include "check_schedule.h"
+
+// 混合精度红黑 Gauss-Seidel（迭代细化），求解 -Δu = f，网格布局与 GaussSeidel2D / 3D 相同
+//
+// 外层（double）：r = f + Δ_h u，‖r‖ < tol 时结束；否则求修正量 -Δ_h e = r，u += e。
+// 内层（float）：从 e = 0 开始对修正方程做红黑扫描，e 和 h² r 都以 float 存放，
+// 每次扫描的访存量是 double 版本的一半。
+// Gauss-Seidel 是仿射迭代，从 0 开始对修正方程扫描 k 次再加回 u，与直接对 u 扫描 k 次在精确算术下相同，
+// 迭代次数与 double 求解器一致；float 的舍入只进入修正量，每次外层迭代都在 double 中重新计算残差，
+// 最终精度由 double 残差决定。
+// 内层扫描次数由 CheckSchedule 按残差下降速度安排（外层次数即检查次数），并限制每次外层迭代
+// 最多把残差降低 MIXED_REFINE_REDUCTION 倍：float 修正量的相对精度约 1e-7，降得更多也会被舍入误差抵消。
+
+const double MIXED_REFINE_REDUCTION = 1e-3;
+
+class MixedPrecisionGS2D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)，包含边界，作为初始猜测
+        const std::vector<double>& f, // 右端项 NxN
+        int N,
+        double h,
+        int max_iter,                 // 最大扫描次数（内层迭代总数）
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 4,
+        CheckStats* stats = nullptr
+    );
+};
+
+class MixedPrecisionGS3D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)x(N+2)，包含边界
+        const std::vector<double>& f, // 右端项 NxNxN
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 8,
+        CheckStats* stats = nullptr
+    );
+};
+
+#endif // MIXED_PRECISION_H
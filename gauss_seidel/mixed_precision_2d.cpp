@@ -0,0 +1,125 @@
+#include "mixed_precision.h"
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+#define U(i, j) u[(size_t)(i) * (N + 2) + (j)]
+#define E(i, j) e[(size_t)(i) * (N + 2) + (j)]
+#define F(i, j) f[(size_t)(i) * N + (j)]
+#define HR(i, j) hr[(size_t)(i) * N + (j)]
+
+namespace {
+
+// 外层残差（double）：r = f + Δ_h u，返回 ‖r‖（与 GaussSeidel2D::compute_residual 相同），
+// 同时把 h² r 以 float 写入 hr，作为修正方程的右端项
+double residual_to_float(
+    const std::vector<double>& u,
+    const std::vector<double>& f,
+    std::vector<float>& hr,
+    int N,
+    double h,
+    int num_threads
+) {
+    const double h2 = h * h;
+    double sum = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:sum) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            double laplacian = (U(i-1, j) + U(i+1, j) + U(i, j-1) + U(i, j+1) - 4.0 * U(i, j)) / h2;
+            double r = F(i-1, j-1) + laplacian;
+            HR(i-1, j-1) = (float)(h2 * r);
+            sum += r * r;
+        }
+    }
+
+    return std::sqrt(sum);
+}
+
+// 内层：对 -Δ_h e = r 做 sweeps 次红黑扫描（float），红点 (i+j)%2==0 先更新，顺序与 solve_parallel_redblack 相同
+void sweep_float(
+    std::vector<float>& e,
+    const std::vector<float>& hr,
+    int N,
+    int sweeps,
+    int num_threads
+) {
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int s = 0; s < sweeps; ++s) {
+            for (int color = 0; color < 2; ++color) {
+                // omp for 结束的隐式 barrier 分隔两种颜色
+                #pragma omp for schedule(static)
+                for (int i = 1; i <= N; ++i) {
+                    int j_start = 1 + (i + 1 + color) % 2;
+                    for (int j = j_start; j <= N; j += 2) {
+                        E(i, j) = 0.25f * (E(i-1, j) + E(i+1, j) + E(i, j-1) + E(i, j+1) + HR(i-1, j-1));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// u += e，同时把 e 清零供下一次外层迭代使用（边界始终为 0）
+void apply_correction(
+    std::vector<double>& u,
+    std::vector<float>& e,
+    int N,
+    int num_threads
+) {
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            U(i, j) += (double)E(i, j);
+            E(i, j) = 0.0f;
+        }
+    }
+}
+
+} // namespace
+
+void MixedPrecisionGS2D::solve(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    CheckStats* stats
+) {
+    std::vector<float> e((size_t)(N + 2) * (N + 2), 0.0f);
+    std::vector<float> hr((size_t)N * N);
+    CheckSchedule schedule;
+
+    iter_count = 0;
+    residual = residual_to_float(u, f, hr, N, h, num_threads);
+
+    while (residual >= tol && iter_count < max_iter) {
+        int steps = std::min(schedule.next_check(), max_iter) - iter_count;
+        double rate = schedule.stats().rate;
+        if (rate > 0.0) {
+            int limit = (int)(std::log(MIXED_REFINE_REDUCTION) / std::log(rate));
+            steps = std::min(steps, std::max(limit, 1));
+        }
+
+        sweep_float(e, hr, N, steps, num_threads);
+        apply_correction(u, e, N, num_threads);
+        iter_count += steps;
+
+        residual = residual_to_float(u, f, hr, N, h, num_threads);
+        schedule.update(residual, iter_count, tol);
+    }
+
+    if (stats) {
+        *stats = schedule.stats();
+    }
+}
+
+#undef U
+#undef E
+#undef F
+#undef HR
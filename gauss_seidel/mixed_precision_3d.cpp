@@ -0,0 +1,133 @@
+#include "mixed_precision.h"
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+#define U(i, j, k) u[((size_t)(i) * (N + 2) + (j)) * (N + 2) + (k)]
+#define E(i, j, k) e[((size_t)(i) * (N + 2) + (j)) * (N + 2) + (k)]
+#define F(i, j, k) f[((size_t)(i) * N + (j)) * N + (k)]
+#define HR(i, j, k) hr[((size_t)(i) * N + (j)) * N + (k)]
+
+namespace {
+
+// 外层残差（double），与 GaussSeidel3D::compute_residual 相同；h² r 以 float 写入 hr
+double residual_to_float(
+    const std::vector<double>& u,
+    const std::vector<double>& f,
+    std::vector<float>& hr,
+    int N,
+    double h,
+    int num_threads
+) {
+    const double h2 = h * h;
+    double sum = 0.0;
+
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:sum) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                double laplacian = (U(i-1, j, k) + U(i+1, j, k) + U(i, j-1, k) + U(i, j+1, k) +
+                                    U(i, j, k-1) + U(i, j, k+1) - 6.0 * U(i, j, k)) / h2;
+                double r = F(i-1, j-1, k-1) + laplacian;
+                HR(i-1, j-1, k-1) = (float)(h2 * r);
+                sum += r * r;
+            }
+        }
+    }
+
+    return std::sqrt(sum);
+}
+
+// 内层：float 红黑扫描，红点 (i+j+k)%2==0 先更新
+void sweep_float(
+    std::vector<float>& e,
+    const std::vector<float>& hr,
+    int N,
+    int sweeps,
+    int num_threads
+) {
+    const float inv6 = 1.0f / 6.0f;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int s = 0; s < sweeps; ++s) {
+            for (int color = 0; color < 2; ++color) {
+                #pragma omp for schedule(static) collapse(2)
+                for (int i = 1; i <= N; ++i) {
+                    for (int j = 1; j <= N; ++j) {
+                        int k_start = 1 + (i + j + 1 + color) % 2;
+                        for (int k = k_start; k <= N; k += 2) {
+                            E(i, j, k) = inv6 * (E(i-1, j, k) + E(i+1, j, k) + E(i, j-1, k) + E(i, j+1, k) +
+                                                 E(i, j, k-1) + E(i, j, k+1) + HR(i-1, j-1, k-1));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// u += e，同时把 e 清零
+void apply_correction(
+    std::vector<double>& u,
+    std::vector<float>& e,
+    int N,
+    int num_threads
+) {
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                U(i, j, k) += (double)E(i, j, k);
+                E(i, j, k) = 0.0f;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void MixedPrecisionGS3D::solve(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    CheckStats* stats
+) {
+    std::vector<float> e((size_t)(N + 2) * (N + 2) * (N + 2), 0.0f);
+    std::vector<float> hr((size_t)N * N * N);
+    CheckSchedule schedule;
+
+    iter_count = 0;
+    residual = residual_to_float(u, f, hr, N, h, num_threads);
+
+    while (residual >= tol && iter_count < max_iter) {
+        int steps = std::min(schedule.next_check(), max_iter) - iter_count;
+        double rate = schedule.stats().rate;
+        if (rate > 0.0) {
+            int limit = (int)(std::log(MIXED_REFINE_REDUCTION) / std::log(rate));
+            steps = std::min(steps, std::max(limit, 1));
+        }
+
+        sweep_float(e, hr, N, steps, num_threads);
+        apply_correction(u, e, N, num_threads);
+        iter_count += steps;
+
+        residual = residual_to_float(u, f, hr, N, h, num_threads);
+        schedule.update(residual, iter_count, tol);
+    }
+
+    if (stats) {
+        *stats = schedule.stats();
+    }
+}
+
+#undef U
+#undef E
+#undef F
+#undef HR
@@ -0,0 +1,66 @@
+#ifndef MULTIGRID_H
+#define MULTIGRID_H
+
+#include <vector>
+
+// 几何多重网格求解器，求解 -Δu = f，边界条件 u = 0，网格布局与 GaussSeidel2D / 3D 相同
+//
+// 光滑器直接使用 GaussSeidel2D/3D::smooth_redblack（并行红黑扫描），
+// 限制和延拓为线性插值及其转置（嵌套网格时即全加权和双线性 / 三线性插值），按行并行。
+// 粗化 N -> (N - 1) / 2，任意 N 都覆盖同一区域，见 multigrid_transfer.h；
+// V(2,2) 循环每次残差下降约一个数量级，与 N 无关。
+//
+// 每个循环后计算一次 L2 残差（与 GaussSeidel 求解器相同的范数），
+// 达到 tol 或残差不再下降（到达舍入误差下限）时停止。
+
+enum MGCycle {
+    MG_V_CYCLE,     // 每层访问粗网格一次
+    MG_W_CYCLE,     // 每层访问粗网格两次，收敛更快，粗网格开销更大
+    MG_FMG          // 完全多重网格：从最粗网格开始逐层插值 + V 循环，之后继续 V 循环
+};
+
+inline const char* mg_cycle_name(MGCycle cycle) {
+    switch (cycle) {
+    case MG_W_CYCLE: return "W";
+    case MG_FMG: return "FMG";
+    default: return "V";
+    }
+}
+
+class Multigrid2D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)，包含边界，作为初始猜测
+        const std::vector<double>& f, // 右端项 NxN
+        int N,
+        double h,
+        MGCycle cycle,
+        int max_cycles,               // 最大循环次数（FMG 的初始化计为一次）
+        double tol,
+        int& cycle_count,             // 实际循环次数
+        double& residual,
+        int num_threads = 4,
+        int pre_smooth = 2,           // 每层前光滑红黑扫描次数
+        int post_smooth = 2           // 每层后光滑红黑扫描次数
+    );
+};
+
+class Multigrid3D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)x(N+2)，包含边界
+        const std::vector<double>& f, // 右端项 NxNxN
+        int N,
+        double h,
+        MGCycle cycle,
+        int max_cycles,
+        double tol,
+        int& cycle_count,
+        double& residual,
+        int num_threads = 8,
+        int pre_smooth = 2,
+        int post_smooth = 2
+    );
+};
+
+#endif // MULTIGRID_H
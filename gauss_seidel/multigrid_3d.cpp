@@ -0,0 +1,257 @@
+#include "multigrid.h"
+#include "gauss_seidel_3d.h"
+#include "multigrid_transfer.h"
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+// 辅助宏：访问三维数组 (N+2)x(N+2)x(N+2)
+#define U(i, j, k) u[((size_t)(i) * (N + 2) + (j)) * (N + 2) + (k)]
+#define F(i, j, k) f[((size_t)(i) * N + (j)) * N + (k)]
+
+namespace {
+
+// 点数少于该值的层串行处理：并行区的启动和屏障开销超过计算量
+const long MG_PARALLEL_MIN_POINTS = 16384;
+
+// 最粗网格（N <= 2）直接做足够多的红黑扫描代替精确求解
+const int MG_COARSEST_N = 2;
+const int MG_COARSEST_SWEEPS = 32;
+
+struct Level {
+    int N;
+    double h;
+    std::vector<double> u;   // (N+2)^3，误差方程的解
+    std::vector<double> f;   // N^3，限制下来的残差
+    std::vector<double> r;   // (N+2)^3，本层残差（边界为 0），供限制读取
+    MGTransfer1D transfer;   // 上一层细网格与本层之间的传递算子
+};
+
+int level_threads(int N, int num_threads) {
+    return (long)N * N * N >= MG_PARALLEL_MIN_POINTS ? num_threads : 1;
+}
+
+// r = f + Δu（-Δu = f 的残差），r 的边界保持为 0
+void compute_residual_grid(
+    const std::vector<double>& u,
+    const std::vector<double>& f,
+    std::vector<double>& r,
+    int N,
+    double h,
+    int num_threads
+) {
+    double inv_h2 = 1.0 / (h * h);
+
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                double laplacian = (U(i-1, j, k) + U(i+1, j, k) + U(i, j-1, k) + U(i, j+1, k) +
+                                    U(i, j, k-1) + U(i, j, k+1) - 6.0 * U(i, j, k)) * inv_h2;
+                r[((size_t)i * (N + 2) + j) * (N + 2) + k] = F(i-1, j-1, k-1) + laplacian;
+            }
+        }
+    }
+}
+
+// 把 N^3 的右端项拷到 (N+2)^3 的带边框数组中，FMG 用同一个限制算子把 f 逐层限制下去
+void pad_rhs(const std::vector<double>& f, std::vector<double>& r, int N, int num_threads) {
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                r[((size_t)i * (N + 2) + j) * (N + 2) + k] = F(i-1, j-1, k-1);
+            }
+        }
+    }
+}
+
+// 限制：粗网格点 (I, J, K) 取细网格残差的 R x R x R 加权和（嵌套时即 27 点全加权）
+void restrict_residual(
+    const std::vector<double>& r,
+    int N,
+    std::vector<double>& fc,
+    const MGTransfer1D& t,
+    int num_threads
+) {
+    const size_t ld = N + 2;
+    const int Nc = t.Nc;
+
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int I = 1; I <= Nc; ++I) {
+        for (int J = 1; J <= Nc; ++J) {
+            for (int K = 1; K <= Nc; ++K) {
+                double sum = 0.0;
+                for (int a = t.row_ptr[I]; a < t.row_ptr[I + 1]; ++a) {
+                    double plane_sum = 0.0;
+                    for (int b = t.row_ptr[J]; b < t.row_ptr[J + 1]; ++b) {
+                        const double* row = &r[(t.fine[a] * ld + t.fine[b]) * ld];
+                        double row_sum = 0.0;
+                        for (int c = t.row_ptr[K]; c < t.row_ptr[K + 1]; ++c) {
+                            row_sum += t.weight[c] * row[t.fine[c]];
+                        }
+                        plane_sum += t.weight[b] * row_sum;
+                    }
+                    sum += t.weight[a] * plane_sum;
+                }
+                fc[((size_t)(I - 1) * Nc + (J - 1)) * Nc + (K - 1)] = sum;
+            }
+        }
+    }
+}
+
+// 三线性延拓并累加：u += P e
+void prolongate_add(
+    std::vector<double>& u,
+    int N,
+    const std::vector<double>& e,
+    const MGTransfer1D& t,
+    int num_threads
+) {
+    const size_t ldc = t.Nc + 2;
+
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            const double* e00 = &e[(t.c0[i] * ldc + t.c0[j]) * ldc];
+            const double* e01 = e00 + ldc;
+            const double* e10 = e00 + ldc * ldc;
+            const double* e11 = e10 + ldc;
+            double wi = t.w[i];
+            double wj = t.w[j];
+            double w00 = (1.0 - wi) * (1.0 - wj);
+            double w01 = (1.0 - wi) * wj;
+            double w10 = wi * (1.0 - wj);
+            double w11 = wi * wj;
+            for (int k = 1; k <= N; ++k) {
+                int K = t.c0[k];
+                double wk = t.w[k];
+                double lo = w00 * e00[K] + w01 * e01[K] + w10 * e10[K] + w11 * e11[K];
+                double hi = w00 * e00[K + 1] + w01 * e01[K + 1] + w10 * e10[K + 1] + w11 * e11[K + 1];
+                U(i, j, k) += (1.0 - wk) * lo + wk * hi;
+            }
+        }
+    }
+}
+
+// 从 (u, f, N, h) 这一层开始做一次 V（gamma = 1）或 W（gamma = 2）循环，
+// levels[next] 是它的下一层粗网格
+void mg_cycle(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    std::vector<double>& r,
+    int N,
+    double h,
+    std::vector<Level>& levels,
+    size_t next,
+    int gamma,
+    int pre_smooth,
+    int post_smooth,
+    int num_threads
+) {
+    int threads = level_threads(N, num_threads);
+    if (next == levels.size()) {
+        GaussSeidel3D::smooth_redblack(u, f, N, h, MG_COARSEST_SWEEPS, threads);
+        return;
+    }
+
+    GaussSeidel3D::smooth_redblack(u, f, N, h, pre_smooth, threads);
+
+    Level& coarse = levels[next];
+    compute_residual_grid(u, f, r, N, h, threads);
+    restrict_residual(r, N, coarse.f, coarse.transfer, level_threads(coarse.N, num_threads));
+
+    std::fill(coarse.u.begin(), coarse.u.end(), 0.0);
+    for (int g = 0; g < gamma; ++g) {
+        mg_cycle(coarse.u, coarse.f, coarse.r, coarse.N, coarse.h, levels, next + 1,
+                 gamma, pre_smooth, post_smooth, num_threads);
+    }
+
+    prolongate_add(u, N, coarse.u, coarse.transfer, threads);
+    GaussSeidel3D::smooth_redblack(u, f, N, h, post_smooth, threads);
+}
+
+} // namespace
+
+void Multigrid3D::solve(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    MGCycle cycle,
+    int max_cycles,
+    double tol,
+    int& cycle_count,
+    double& residual,
+    int num_threads,
+    int pre_smooth,
+    int post_smooth
+) {
+    // 建立粗网格层次
+    std::vector<Level> levels;
+    int n = N;
+    double hc = h;
+    while (n > MG_COARSEST_N) {
+        int nc = mg_coarse_size(n);
+        hc = hc * (n + 1) / (nc + 1);
+        Level level;
+        level.N = nc;
+        level.h = hc;
+        level.transfer = mg_make_transfer(n, nc);
+        level.u.assign((size_t)(nc + 2) * (nc + 2) * (nc + 2), 0.0);
+        level.f.assign((size_t)nc * nc * nc, 0.0);
+        level.r.assign((size_t)(nc + 2) * (nc + 2) * (nc + 2), 0.0);
+        levels.push_back(level);
+        n = nc;
+    }
+    std::vector<double> r((size_t)(N + 2) * (N + 2) * (N + 2), 0.0);
+
+    cycle_count = 0;
+
+    if (cycle == MG_FMG && !levels.empty() && max_cycles > 0) {
+        // 右端项逐层限制到最粗网格
+        pad_rhs(f, r, N, level_threads(N, num_threads));
+        restrict_residual(r, N, levels[0].f, levels[0].transfer, level_threads(levels[0].N, num_threads));
+        for (size_t l = 1; l < levels.size(); ++l) {
+            Level& fine = levels[l - 1];
+            pad_rhs(fine.f, fine.r, fine.N, level_threads(fine.N, num_threads));
+            restrict_residual(fine.r, fine.N, levels[l].f, levels[l].transfer,
+                              level_threads(levels[l].N, num_threads));
+        }
+
+        // 最粗网格求解，然后逐层插值到细一层作为初值并做一次 V 循环
+        Level& coarsest = levels.back();
+        std::fill(coarsest.u.begin(), coarsest.u.end(), 0.0);
+        GaussSeidel3D::smooth_redblack(coarsest.u, coarsest.f, coarsest.N, coarsest.h, MG_COARSEST_SWEEPS, 1);
+        for (size_t l = levels.size() - 1; l > 0; --l) {
+            Level& fine = levels[l - 1];
+            int threads = level_threads(fine.N, num_threads);
+            std::fill(fine.u.begin(), fine.u.end(), 0.0);
+            prolongate_add(fine.u, fine.N, levels[l].u, levels[l].transfer, threads);
+            mg_cycle(fine.u, fine.f, fine.r, fine.N, fine.h, levels, l, 1,
+                     pre_smooth, post_smooth, num_threads);
+        }
+        std::fill(u.begin(), u.end(), 0.0);
+        prolongate_add(u, N, levels[0].u, levels[0].transfer, level_threads(N, num_threads));
+        mg_cycle(u, f, r, N, h, levels, 0, 1, pre_smooth, post_smooth, num_threads);
+        cycle_count = 1;
+        residual = GaussSeidel3D::compute_residual(u, f, N, h);
+    } else {
+        residual = GaussSeidel3D::compute_residual(u, f, N, h);
+    }
+
+    int gamma = (cycle == MG_W_CYCLE) ? 2 : 1;
+    while (cycle_count < max_cycles && residual >= tol) {
+        mg_cycle(u, f, r, N, h, levels, 0, gamma, pre_smooth, post_smooth, num_threads);
+        ++cycle_count;
+        double previous = residual;
+        residual = GaussSeidel3D::compute_residual(u, f, N, h);
+        // 残差不再明显下降：已到达舍入误差下限，继续循环没有意义
+        if (residual > 0.9 * previous) {
+            break;
+        }
+    }
+}
+
+#undef U
+#undef F
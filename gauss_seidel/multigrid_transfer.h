@@ -0,0 +1,71 @@
+#ifndef MULTIGRID_TRANSFER_H
+#define MULTIGRID_TRANSFER_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// 多重网格的一维网格传递算子，2D / 3D 按维做张量积（multigrid_2d.cpp / multigrid_3d.cpp 内部使用）
+//
+// 细网格内部点 i = 1..N 位于 x = i / (N+1)，粗网格内部点 I = 1..Nc 位于 X = I / (Nc+1)，
+// 两者覆盖同一个区间 [0, 1]，边界点都是 0。
+//   延拓 P：细网格点取左右相邻两个粗网格点的线性插值
+//   限制 R = (h / H) * P^T：每维的权重之和为 1，嵌套网格（N = 2Nc + 1）时即全加权 [1/4 1/2 1/4]
+// 粗网格取 Nc = (N - 1) / 2：N = 2^k - 1 时各层都严格嵌套；
+// 其他 N（如 1024）只有第一层不嵌套，间距比约为 2，之后各层又是 2^k - 1。
+
+struct MGTransfer1D {
+    int N;
+    int Nc;
+
+    // 延拓：细网格点 i 取 (1 - w[i]) * e[c0[i]] + w[i] * e[c0[i] + 1]（粗网格下标含边界 0..Nc+1）
+    std::vector<int> c0;
+    std::vector<double> w;
+
+    // 限制（CSR）：粗网格点 I 的贡献细网格点 fine[k]、权重 weight[k]，k 属于 [row_ptr[I], row_ptr[I+1])
+    std::vector<int> row_ptr;
+    std::vector<int> fine;
+    std::vector<double> weight;
+};
+
+inline int mg_coarse_size(int N) {
+    return (N - 1) / 2;
+}
+
+inline MGTransfer1D mg_make_transfer(int N, int Nc) {
+    MGTransfer1D t;
+    t.N = N;
+    t.Nc = Nc;
+    t.c0.assign(N + 2, 0);
+    t.w.assign(N + 2, 0.0);
+
+    // 粗网格坐标 i * (Nc+1) / (N+1)，整数运算，嵌套时权重严格为 0 或 1/2
+    std::vector<std::vector<std::pair<int, double> > > rows(Nc + 2);
+    for (int i = 1; i <= N; ++i) {
+        long num = (long)i * (Nc + 1);
+        int I0 = (int)(num / (N + 1));
+        double wi = (double)(num - (long)I0 * (N + 1)) / (N + 1);
+        t.c0[i] = I0;
+        t.w[i] = wi;
+        if (I0 >= 1 && 1.0 - wi > 0.0) {
+            rows[I0].push_back(std::make_pair(i, 1.0 - wi));
+        }
+        if (I0 + 1 <= Nc && wi > 0.0) {
+            rows[I0 + 1].push_back(std::make_pair(i, wi));
+        }
+    }
+
+    double scale = (double)(Nc + 1) / (N + 1);
+    t.row_ptr.assign(Nc + 2, 0);
+    for (int I = 1; I <= Nc; ++I) {
+        t.row_ptr[I] = (int)t.fine.size();
+        for (std::size_t k = 0; k < rows[I].size(); ++k) {
+            t.fine.push_back(rows[I][k].first);
+            t.weight.push_back(scale * rows[I][k].second);
+        }
+    }
+    t.row_ptr[Nc + 1] = (int)t.fine.size();
+    return t;
+}
+
+#endif // MULTIGRID_TRANSFER_H
@@ -0,0 +1,59 @@
+#ifndef PCG_H
+#define PCG_H
+
+#include <vector>
+
+// 无矩阵的预条件共轭梯度（PCG）求解器，求解 -Δu = f，边界条件 u = 0，网格布局与 GaussSeidel2D / 3D 相同
+//
+// 系统矩阵 A = -Δ_h 对称正定，只以模板形式出现（matvec 直接对网格做 5 点 / 7 点差分）。
+// 预条件子 PCG_SGS 为一次对称红黑扫描（GaussSeidel2D/3D::symmetric_sweep_redblack，红、黑、红），
+// 初值为 0 时等价于对称 Gauss-Seidel 预条件矩阵，保持 PCG 所需的对称正定性。
+//
+// 每次迭代的内存遍历（N^d 个点）：
+//   q = A p 与 p·q 合并为一遍
+//   u += αp、r -= αq 与 ‖r‖² 合并为一遍
+//   z = M⁻¹ r（清零 + 三次半扫描），r·z 一遍，p = z + βp 一遍
+// 迭代次数为 O(N)（无预条件）或约减半（SGS），残差范数与 GaussSeidel 求解器相同。
+
+enum PCGPreconditioner {
+    PCG_NONE,       // 普通 CG
+    PCG_SGS         // 对称红黑 Gauss-Seidel
+};
+
+inline const char* pcg_preconditioner_name(PCGPreconditioner precond) {
+    return precond == PCG_SGS ? "SGS" : "none";
+}
+
+class PCG2D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)，包含边界，作为初始猜测
+        const std::vector<double>& f, // 右端项 NxN
+        int N,
+        double h,
+        PCGPreconditioner precond,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 4
+    );
+};
+
+class PCG3D {
+public:
+    static void solve(
+        std::vector<double>& u,       // 解向量 (N+2)x(N+2)x(N+2)，包含边界
+        const std::vector<double>& f, // 右端项 NxNxN
+        int N,
+        double h,
+        PCGPreconditioner precond,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 8
+    );
+};
+
+#endif // PCG_H
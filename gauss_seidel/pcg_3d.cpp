@@ -0,0 +1,199 @@
+#include "pcg.h"
+#include "gauss_seidel_3d.h"
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+// 辅助宏：(N+2)^3 带边界数组和 N^3 内部数组（i, j, k 为 1..N 的网格下标）
+#define PAD(a, i, j, k) a[((size_t)(i) * (N + 2) + (j)) * (N + 2) + (k)]
+#define IN(a, i, j, k) a[((size_t)((i) - 1) * N + ((j) - 1)) * N + ((k) - 1)]
+
+namespace {
+
+// r = f - A u，返回 ‖r‖²
+double initial_residual(
+    const std::vector<double>& u,
+    const std::vector<double>& f,
+    std::vector<double>& r,
+    int N,
+    double inv_h2,
+    int num_threads
+) {
+    double rr = 0.0;
+
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:rr) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                double au = (6.0 * PAD(u, i, j, k) - PAD(u, i-1, j, k) - PAD(u, i+1, j, k)
+                             - PAD(u, i, j-1, k) - PAD(u, i, j+1, k)
+                             - PAD(u, i, j, k-1) - PAD(u, i, j, k+1)) * inv_h2;
+                double ri = IN(f, i, j, k) - au;
+                IN(r, i, j, k) = ri;
+                rr += ri * ri;
+            }
+        }
+    }
+    return rr;
+}
+
+// q = A p，同时返回 p·q
+double apply_and_dot(
+    const std::vector<double>& p,
+    std::vector<double>& q,
+    int N,
+    double inv_h2,
+    int num_threads
+) {
+    double pq = 0.0;
+
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:pq) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                double pc = PAD(p, i, j, k);
+                double ap = (6.0 * pc - PAD(p, i-1, j, k) - PAD(p, i+1, j, k)
+                             - PAD(p, i, j-1, k) - PAD(p, i, j+1, k)
+                             - PAD(p, i, j, k-1) - PAD(p, i, j, k+1)) * inv_h2;
+                IN(q, i, j, k) = ap;
+                pq += pc * ap;
+            }
+        }
+    }
+    return pq;
+}
+
+// u += αp，r -= αq，同时返回 ‖r‖²
+double update_and_norm(
+    std::vector<double>& u,
+    std::vector<double>& r,
+    const std::vector<double>& p,
+    const std::vector<double>& q,
+    double alpha,
+    int N,
+    int num_threads
+) {
+    double rr = 0.0;
+
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:rr) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            double* ui = &PAD(u, i, j, 1);
+            const double* pi = &PAD(p, i, j, 1);
+            double* ri = &IN(r, i, j, 1);
+            const double* qi = &IN(q, i, j, 1);
+            for (int k = 0; k < N; ++k) {
+                ui[k] += alpha * pi[k];
+                ri[k] -= alpha * qi[k];
+                rr += ri[k] * ri[k];
+            }
+        }
+    }
+    return rr;
+}
+
+// z = M⁻¹ r（一次对称红黑扫描，z 初值为 0），返回 r·z
+double precondition_sgs(
+    std::vector<double>& z,
+    const std::vector<double>& r,
+    int N,
+    double h,
+    int num_threads
+) {
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            std::fill(&PAD(z, i, j, 1), &PAD(z, i, j, 1) + N, 0.0);
+        }
+    }
+
+    GaussSeidel3D::symmetric_sweep_redblack(z, r, N, h, num_threads);
+
+    double rz = 0.0;
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:rz) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            const double* ri = &IN(r, i, j, 1);
+            const double* zi = &PAD(z, i, j, 1);
+            for (int k = 0; k < N; ++k) {
+                rz += ri[k] * zi[k];
+            }
+        }
+    }
+    return rz;
+}
+
+// p = z + βp；z_padded 为 false 时 z 是 N^3 数组（无预条件时 z 即 r）
+void update_direction(
+    std::vector<double>& p,
+    const std::vector<double>& z,
+    bool z_padded,
+    double beta,
+    int N,
+    int num_threads
+) {
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            const double* zi = z_padded ? &PAD(z, i, j, 1) : &IN(z, i, j, 1);
+            double* pi = &PAD(p, i, j, 1);
+            for (int k = 0; k < N; ++k) {
+                pi[k] = zi[k] + beta * pi[k];
+            }
+        }
+    }
+}
+
+} // namespace
+
+void PCG3D::solve(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    PCGPreconditioner precond,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads
+) {
+    const double inv_h2 = 1.0 / (h * h);
+    const bool use_sgs = (precond == PCG_SGS);
+    const size_t padded = (size_t)(N + 2) * (N + 2) * (N + 2);
+    const size_t interior = (size_t)N * N * N;
+
+    std::vector<double> r(interior);
+    std::vector<double> q(interior);
+    std::vector<double> p(padded, 0.0);
+    std::vector<double> z;
+    if (use_sgs) {
+        z.assign(padded, 0.0);
+    }
+
+    double rr = initial_residual(u, f, r, N, inv_h2, num_threads);
+    double rz = use_sgs ? precondition_sgs(z, r, N, h, num_threads) : rr;
+    update_direction(p, use_sgs ? z : r, use_sgs, 0.0, N, num_threads);
+
+    iter_count = 0;
+    while (iter_count < max_iter && std::sqrt(rr) >= tol) {
+        double pq = apply_and_dot(p, q, N, inv_h2, num_threads);
+        double alpha = rz / pq;
+        rr = update_and_norm(u, r, p, q, alpha, N, num_threads);
+        ++iter_count;
+        if (std::sqrt(rr) < tol) {
+            break;
+        }
+
+        double rz_new = use_sgs ? precondition_sgs(z, r, N, h, num_threads) : rr;
+        double beta = rz_new / rz;
+        rz = rz_new;
+        update_direction(p, use_sgs ? z : r, use_sgs, beta, N, num_threads);
+    }
+
+    // 递推残差会累积舍入误差，最终残差按定义重新计算
+    residual = GaussSeidel3D::compute_residual(u, f, N, h);
+}
+
+#undef PAD
+#undef IN
@@ -0,0 +1,175 @@
+#ifndef REDBLACK_SPLIT_H
+#define REDBLACK_SPLIT_H
+
+#include <vector>
+#include "check_schedule.h"
+
+// 红黑分离存储的 Gauss-Seidel，求解 -Δu = f，更新顺序与 GaussSeidel2D/3D::solve_parallel_redblack 相同
+// （不做 FMA 收缩时结果逐位一致；-mfma 下交错版本会把 h^2 f 融合进加法，差别在舍入误差量级）
+//
+// 交错存储中同色点相隔一个元素，红黑内核都是 j += 2（3D 为 k += 2）的跨步循环：
+// 每条缓存行只用到一半数据，编译器也基本不做向量化。这里把每一行（3D 为每个 (i, j) 对应的 k 行）
+// 按颜色拆成两个紧凑数组：
+//   颜色 c 的第 m 个元素是该行中第 m 个颜色为 c 的点，列下标 j = 2m + o，
+//   o = (i + c) % 2（3D 为 (i + j + c) % 2），c = 0 为红点 (i+j) % 2 == 0
+// 上下（3D 还有前后）相邻行中异色邻居的下标同样是 m，同一行左右邻居的下标为 m - 1 + o 和 m + o，
+// 更新一种颜色变成对另一种颜色数组的连续访问，内循环是单位步长的 SIMD 循环。
+// 两种颜色各占 (N+2) 行（3D 为 (N+2)^2 行），每行 W 个元素（W 取 8 的倍数，行长为 64 字节的整数倍），
+// 包含边界点；右端项按同样布局预先乘以 h^2。
+
+// 一行中颜色 c 的内部点下标范围 [m_lo, m_hi]：j = 2m + o 落在 1..N
+inline int split_row_begin(int o) {
+    return (o == 1) ? 0 : 1;
+}
+
+inline int split_row_end(int N, int o) {
+    return (N - o) / 2;
+}
+
+// 2D 行更新：dst[m] = (up[m] + down[m] + cur[m-1+o] + cur[m+o] + hf[m]) / 4
+inline void split_update_row_2d(
+    double* dst,
+    const double* up,
+    const double* down,
+    const double* cur,
+    const double* hf,
+    int m_lo,
+    int m_hi,
+    int o
+) {
+    const double* left = cur - 1 + o;
+    const double* right = cur + o;
+    #pragma omp simd
+    for (int m = m_lo; m <= m_hi; ++m) {
+        dst[m] = 0.25 * (up[m] + down[m] + left[m] + right[m] + hf[m]);
+    }
+}
+
+// 3D 行更新：六个邻居中四个在相邻行的同一下标，两个在本行
+inline void split_update_row_3d(
+    double* dst,
+    const double* im,
+    const double* ip,
+    const double* jm,
+    const double* jp,
+    const double* cur,
+    const double* hf,
+    int m_lo,
+    int m_hi,
+    int o
+) {
+    const double inv6 = 1.0 / 6.0;
+    const double* left = cur - 1 + o;
+    const double* right = cur + o;
+    #pragma omp simd
+    for (int m = m_lo; m <= m_hi; ++m) {
+        dst[m] = inv6 * (im[m] + ip[m] + jm[m] + jp[m] + left[m] + right[m] + hf[m]);
+    }
+}
+
+struct SplitGrid2D {
+    int N;
+    int W;                          // 每行每种颜色的元素数
+    std::vector<double> u[2];       // (N+2) x W，下标 [c][i * W + m]
+    std::vector<double> hf[2];      // h^2 f，同样布局，边界行为 0
+};
+
+struct SplitGrid3D {
+    int N;
+    int W;
+    std::vector<double> u[2];       // (N+2) x (N+2) x W，下标 [c][(i * (N+2) + j) * W + m]
+    std::vector<double> hf[2];
+};
+
+class RedBlackSplit2D {
+public:
+    // 交错存储 -> 分离存储（u 含边界，f 为 NxN）
+    static void to_split(
+        const std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        SplitGrid2D& g,
+        int num_threads = 4
+    );
+
+    // 分离存储 -> 交错存储（写回全部 (N+2)x(N+2) 点）
+    static void from_split(
+        const SplitGrid2D& g,
+        std::vector<double>& u,
+        int num_threads = 4
+    );
+
+    // 固定次数的红黑扫描
+    static void sweep(
+        SplitGrid2D& g,
+        int sweeps,
+        int num_threads = 4
+    );
+
+    // 残差范数，与 GaussSeidel2D::compute_residual 相同
+    static double compute_residual(
+        const SplitGrid2D& g,
+        double h,
+        int num_threads = 4
+    );
+
+    // 完整求解：转换、迭代（检查时机由 CheckSchedule 安排，与 solve_parallel_redblack 相同）、写回
+    static void solve(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 4,
+        CheckStats* stats = nullptr
+    );
+};
+
+class RedBlackSplit3D {
+public:
+    static void to_split(
+        const std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        SplitGrid3D& g,
+        int num_threads = 8
+    );
+
+    static void from_split(
+        const SplitGrid3D& g,
+        std::vector<double>& u,
+        int num_threads = 8
+    );
+
+    static void sweep(
+        SplitGrid3D& g,
+        int sweeps,
+        int num_threads = 8
+    );
+
+    static double compute_residual(
+        const SplitGrid3D& g,
+        double h,
+        int num_threads = 8
+    );
+
+    static void solve(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads = 8,
+        CheckStats* stats = nullptr
+    );
+};
+
+#endif // REDBLACK_SPLIT_H
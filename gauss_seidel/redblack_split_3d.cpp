@@ -0,0 +1,171 @@
+#include "redblack_split.h"
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+
+// 颜色数组中 (i, j) 行的起始地址
+#define ROW(a, i, j) (&(a)[((size_t)(i) * (N + 2) + (j)) * W])
+
+void RedBlackSplit3D::to_split(
+    const std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    SplitGrid3D& g,
+    int num_threads
+) {
+    const double h2 = h * h;
+    const int W = ((N + 3) / 2 + 7) / 8 * 8;
+    g.N = N;
+    g.W = W;
+    for (int c = 0; c < 2; ++c) {
+        g.u[c].assign((size_t)(N + 2) * (N + 2) * W, 0.0);
+        g.hf[c].assign((size_t)(N + 2) * (N + 2) * W, 0.0);
+    }
+
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 0; i <= N + 1; ++i) {
+        for (int j = 0; j <= N + 1; ++j) {
+            bool interior = (i >= 1 && i <= N && j >= 1 && j <= N);
+            for (int c = 0; c < 2; ++c) {
+                int o = (i + j + c) % 2;
+                double* dst = ROW(g.u[c], i, j);
+                double* hf = ROW(g.hf[c], i, j);
+                for (int m = 0, k = o; k <= N + 1; ++m, k += 2) {
+                    dst[m] = u[((size_t)i * (N + 2) + j) * (N + 2) + k];
+                    if (interior && k >= 1 && k <= N) {
+                        hf[m] = h2 * f[((size_t)(i - 1) * N + (j - 1)) * N + (k - 1)];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void RedBlackSplit3D::from_split(
+    const SplitGrid3D& g,
+    std::vector<double>& u,
+    int num_threads
+) {
+    const int N = g.N;
+    const int W = g.W;
+
+    #pragma omp parallel for schedule(static) collapse(2) num_threads(num_threads)
+    for (int i = 0; i <= N + 1; ++i) {
+        for (int j = 0; j <= N + 1; ++j) {
+            for (int c = 0; c < 2; ++c) {
+                int o = (i + j + c) % 2;
+                const double* src = ROW(g.u[c], i, j);
+                for (int m = 0, k = o; k <= N + 1; ++m, k += 2) {
+                    u[((size_t)i * (N + 2) + j) * (N + 2) + k] = src[m];
+                }
+            }
+        }
+    }
+}
+
+void RedBlackSplit3D::sweep(
+    SplitGrid3D& g,
+    int sweeps,
+    int num_threads
+) {
+    const int N = g.N;
+    const int W = g.W;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        for (int s = 0; s < sweeps; ++s) {
+            for (int c = 0; c < 2; ++c) {
+                std::vector<double>& dst = g.u[c];
+                const std::vector<double>& src = g.u[1 - c];
+                const std::vector<double>& hf = g.hf[c];
+
+                #pragma omp for schedule(static) collapse(2)
+                for (int i = 1; i <= N; ++i) {
+                    for (int j = 1; j <= N; ++j) {
+                        int o = (i + j + c) % 2;
+                        split_update_row_3d(ROW(dst, i, j),
+                                            ROW(src, i - 1, j), ROW(src, i + 1, j),
+                                            ROW(src, i, j - 1), ROW(src, i, j + 1),
+                                            ROW(src, i, j), ROW(hf, i, j),
+                                            split_row_begin(o), split_row_end(N, o), o);
+                    }
+                }
+            }
+        }
+    }
+}
+
+double RedBlackSplit3D::compute_residual(
+    const SplitGrid3D& g,
+    double h,
+    int num_threads
+) {
+    const int N = g.N;
+    const int W = g.W;
+    const double inv_h2 = 1.0 / (h * h);
+    double sum = 0.0;
+
+    #pragma omp parallel for schedule(static) collapse(2) reduction(+:sum) num_threads(num_threads)
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int c = 0; c < 2; ++c) {
+                int o = (i + j + c) % 2;
+                const double* uc = ROW(g.u[c], i, j);
+                const double* im = ROW(g.u[1 - c], i - 1, j);
+                const double* ip = ROW(g.u[1 - c], i + 1, j);
+                const double* jm = ROW(g.u[1 - c], i, j - 1);
+                const double* jp = ROW(g.u[1 - c], i, j + 1);
+                const double* left = ROW(g.u[1 - c], i, j) - 1 + o;
+                const double* right = ROW(g.u[1 - c], i, j) + o;
+                const double* hf = ROW(g.hf[c], i, j);
+                int m_hi = split_row_end(N, o);
+                for (int m = split_row_begin(o); m <= m_hi; ++m) {
+                    double r = (hf[m] + im[m] + ip[m] + jm[m] + jp[m] + left[m] + right[m]
+                                - 6.0 * uc[m]) * inv_h2;
+                    sum += r * r;
+                }
+            }
+        }
+    }
+
+    return std::sqrt(sum);
+}
+
+void RedBlackSplit3D::solve(
+    std::vector<double>& u,
+    const std::vector<double>& f,
+    int N,
+    double h,
+    int max_iter,
+    double tol,
+    int& iter_count,
+    double& residual,
+    int num_threads,
+    CheckStats* stats
+) {
+    CheckSchedule schedule;
+
+    SplitGrid3D g;
+    to_split(u, f, N, h, g, num_threads);
+
+    iter_count = 0;
+    residual = 0.0;
+    while (iter_count < max_iter) {
+        int steps = std::min(schedule.next_check(), max_iter) - iter_count;
+        sweep(g, steps, num_threads);
+        iter_count += steps;
+        residual = compute_residual(g, h, num_threads);
+        schedule.update(residual, iter_count, tol);
+        if (residual < tol) {
+            break;
+        }
+    }
+    if (stats) {
+        *stats = schedule.stats();
+    }
+
+    from_split(g, u, num_threads);
+}
+
+#undef ROW
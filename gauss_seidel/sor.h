@@ -0,0 +1,117 @@
+#ifndef SOR_H
+#define SOR_H
+
+#include <algorithm>
+#include <cmath>
+
+// 逐次超松弛（SOR / SSOR）的松弛因子选择，GaussSeidel2D / 3D 共用
+//
+// 求解器的 omega 参数：
+//   omega > 0   固定松弛因子（1 即 Gauss-Seidel）
+//   omega == 0  按模型泊松问题的理论最优值：Jacobi 谱半径 ρ_J = cos(πh)（2D、3D 相同）
+//   omega < 0   自适应：从 omega == 0 的值开始，由残差历史检查 ω 是否偏小，偏小时按 Young 关系提高（SorEstimator）；
+//               只会提高，不会低于按 h 给出的值。SSOR 的收敛因子与 ρ_J 没有这样的关系，自适应即按 h 取值
+// 自然序和红黑序都是相容次序，最优 ω 相同；迭代次数从 O(N²) 降到 O(N)。
+//
+// 不先按 ω = 1 迭代来估计 ρ_J：几十次 Gauss-Seidel 迭代只能看到高频误差的快速衰减，
+// 渐近收敛因子要 O(N²) 次迭代才显现，估计出的 ρ_J 偏小、ω 远低于最优（N = 255 时迭代次数多约 10 倍）。
+
+const double SOR_PI = 3.14159265358979323846;
+
+// 模型问题的 Jacobi 谱半径
+inline double sor_jacobi_radius(double h) {
+    return std::cos(SOR_PI * h);
+}
+
+// SOR 最优松弛因子 2 / (1 + sqrt(1 - ρ_J²))，模型问题即 2 / (1 + sin(πh))
+inline double sor_optimal_omega(double rho_j) {
+    return 2.0 / (1.0 + std::sqrt(1.0 - rho_j * rho_j));
+}
+
+// SSOR（前向 + 后向扫描）的近似最优松弛因子 2 / (1 + sqrt(2(1 - ρ_J)))
+inline double ssor_optimal_omega(double rho_j) {
+    return 2.0 / (1.0 + std::sqrt(2.0 * (1.0 - rho_j)));
+}
+
+// 按 omega 参数的约定取迭代开始时的松弛因子；自适应模式从按 h 的最优值开始
+inline double sor_initial_omega(double omega, double h, bool symmetric) {
+    if (omega > 0.0) {
+        return omega;
+    }
+    double rho_j = sor_jacobi_radius(h);
+    return symmetric ? ssor_optimal_omega(rho_j) : sor_optimal_omega(rho_j);
+}
+
+// 自适应 SOR：检查当前 ω 是否低于最优值，低于时由渐近收敛因子按 Young 关系估计 ρ_J 并提高 ω。
+//
+// 相容次序的 SOR 中，ω 低于最优值时渐近收敛因子 λ 是实数且满足 (λ + ω - 1)² = λ ω² ρ_J²，
+// 由测得的 λ 可以反解 ρ_J；ω 不低于最优值时 λ = ω - 1，e 倍衰减约需 1 / (2 - ω) 次迭代。
+// 采样窗口取 4 / (2 - ω) 次迭代（至少 MIN_WINDOW），这样窗口覆盖渐近区间，
+// ω 在最优值时 Jordan 块带来的多项式因子也只使测得的 1 - λ 偏小约 20%。
+// 1 - λ 不小于 (2 - ω) / 2 视为 ω 已够大，连续 CONFIRM 个窗口如此即结束估计；
+// 否则按 Young 关系提高 ω，丢弃切换后的第一个窗口（过渡过程）重新测量。
+// 每次切换都提高 ω，初始值又是按 h 的最优值，所以 ω 不会低于按 h 给出的值。
+class SorEstimator {
+public:
+    static const int MIN_WINDOW = 10;
+    static const int CONFIRM = 2;
+    static const int MAX_SAMPLES = 12;   // 采样上限，之后保持当前 ω
+
+    explicit SorEstimator(double omega)
+        : omega_(omega), base_iter_(-1), base_residual_(0.0), confirmed_(0), samples_(0), done_(false) {
+        next_ = window();
+    }
+
+    double omega() const { return omega_; }
+    bool done() const { return done_; }
+
+    // 下一次采样时已完成的迭代次数
+    int next_sample() const { return next_; }
+
+    // 已完成 iter 次迭代时的残差，之后由 omega() 取（可能已提高的）ω
+    void update(double residual, int iter) {
+        bool changed = false;
+        ++samples_;
+        if (base_iter_ >= 0 && iter > base_iter_ && base_residual_ > 0.0 && residual > 0.0) {
+            double rate = std::pow(residual / base_residual_, 1.0 / (iter - base_iter_));
+            if (rate < 1.0) {
+                if (1.0 - rate >= 0.5 * (2.0 - omega_)) {
+                    done_ = ++confirmed_ >= CONFIRM;
+                } else {
+                    double rho_j = (rate + omega_ - 1.0) / (omega_ * std::sqrt(rate));
+                    double w = sor_optimal_omega(std::min(rho_j, 1.0 - 1e-12));
+                    if (w > omega_) {
+                        omega_ = w;
+                        changed = true;
+                    }
+                    confirmed_ = 0;
+                }
+            }
+        }
+        if (samples_ >= MAX_SAMPLES) {
+            done_ = true;
+        }
+        if (changed) {
+            base_iter_ = -1;
+        } else {
+            base_iter_ = iter;
+            base_residual_ = residual;
+        }
+        next_ = iter + window();
+    }
+
+private:
+    int window() const {
+        return std::max(MIN_WINDOW, (int)std::ceil(4.0 / (2.0 - omega_)));
+    }
+
+    double omega_;
+    int base_iter_;             // 测量区间起点，-1 表示下一次采样只记录起点
+    double base_residual_;
+    int confirmed_;
+    int samples_;
+    bool done_;
+    int next_;
+};
+
+#endif // SOR_H
@@ -0,0 +1,560 @@
+#ifndef STENCIL_OPERATOR_H
+#define STENCIL_OPERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <omp.h>
+#include "check_schedule.h"
+#include "stencil_simd.h"
+
+// 通用模板算子的红黑 Gauss-Seidel：求解 -∇·(a ∇u) = f，网格布局与 GaussSeidel2D / 3D 相同
+// （u 为 (N+2)^d，含边界层；f 为 N^d），各方向间距可以不同（hx、hy、hz）。
+//
+// 离散：面系数 c = a_face / h²，A u = Σ c (u - u_nb)，Gauss-Seidel 更新 u = (f + Σ c u_nb) / Σ c。
+// 系数以策略类给出，StencilGS2D/3D<Coeff> 在编译期展开：
+//   UnitCoeff2D/3D   a ≡ 1，系数是编译期常量，只有间距是运行时的。间距相等时行更新直接调用
+//                    stencil_rb_row_2d/3d（AVX2 / AVX-512 向量内核），与 *_tiled_aligned 的内层相同，
+//                    结果与 solve_4level_tiling_aligned 逐位一致；向量内核把 h² f 用 FMA 融合，与标量的
+//                    solve_parallel_redblack 只在舍入误差量级上不同（GS_STENCIL_ISA=scalar 时逐位一致）；
+//                    常数各向异性扩散 a = diag(ax, ay) 等价于间距 h / sqrt(a)，同样用这个策略。
+//   ArrayCoeff2D/3D  a 在 (N+2)^d 个网格点上给出，面系数取相邻两点的调和平均，预先算好面系数和 1 / Σ c。
+// 扫描按二维（3D 为三维）块划分给线程，块内逐行调用行内核，同步方式与 solve_parallel_redblack 相同。
+//
+// 边界：每个面独立选 Dirichlet 或 Neumann。
+//   Dirichlet  边界值就是 u 的边界层（与现有求解器相同，调用方写入）
+//   Neumann    外法向导数 ∂u/∂n = g，每个半扫描之前由一阶差分重写边界层：u_0 = u_1 + h g
+// 全部为 Neumann 时问题奇异（解差一个常数，f 需满足相容条件），迭代不会收敛到给定容差。
+
+enum BoundaryType {
+    BC_DIRICHLET,
+    BC_NEUMANN
+};
+
+// 面编号：0 为 i = 0，1 为 i = N+1，2 为 j = 0，3 为 j = N+1（3D 另有 4 为 k = 0，5 为 k = N+1）
+struct Boundary2D {
+    BoundaryType type[4];
+    std::vector<double> flux[4];    // Neumann 面的 ∂u/∂n，长度 N（沿面的另一个下标 1..N），空表示 0
+
+    Boundary2D() {
+        for (int s = 0; s < 4; ++s) {
+            type[s] = BC_DIRICHLET;
+        }
+    }
+
+    bool has_neumann() const {
+        for (int s = 0; s < 4; ++s) {
+            if (type[s] == BC_NEUMANN) return true;
+        }
+        return false;
+    }
+
+    double g(int side, int t) const {
+        return flux[side].empty() ? 0.0 : flux[side][t];
+    }
+};
+
+struct Boundary3D {
+    BoundaryType type[6];
+    std::vector<double> flux[6];    // 长度 N * N，下标 (a - 1) * N + (b - 1)，(a, b) 为面内按 i、j、k 顺序的两个下标
+
+    Boundary3D() {
+        for (int s = 0; s < 6; ++s) {
+            type[s] = BC_DIRICHLET;
+        }
+    }
+
+    bool has_neumann() const {
+        for (int s = 0; s < 6; ++s) {
+            if (type[s] == BC_NEUMANN) return true;
+        }
+        return false;
+    }
+
+    double g(int side, int a, int b, int N) const {
+        return flux[side].empty() ? 0.0 : flux[side][(size_t)a * N + b];
+    }
+};
+
+// ========== 系数策略 ==========
+// 接口：hx / hy（/ hz），面系数 xm / xp / ym / yp（/ zm / zp）(i, j[, k])，inv_diag = 1 / Σ c
+
+struct UnitCoeff2D {
+    double hx, hy;
+    double wx, wy;                  // 1 / hx²，1 / hy²
+    double inv_d;
+    bool isotropic;
+
+    UnitCoeff2D(double hx_, double hy_)
+        : hx(hx_), hy(hy_), wx(1.0 / (hx_ * hx_)), wy(1.0 / (hy_ * hy_)),
+          inv_d(1.0 / (2.0 * (wx + wy))), isotropic(hx_ == hy_) {}
+
+    double xm(int, int) const { return wx; }
+    double xp(int, int) const { return wx; }
+    double ym(int, int) const { return wy; }
+    double yp(int, int) const { return wy; }
+    double inv_diag(int, int) const { return inv_d; }
+};
+
+struct ArrayCoeff2D {
+    int N;
+    double hx, hy;
+    std::vector<double> cx;         // 点 (i, j) 与 (i+1, j) 之间的面系数，下标 i * (N+2) + j
+    std::vector<double> cy;         // 点 (i, j) 与 (i, j+1) 之间
+    std::vector<double> inv_d;
+
+    // a 为 (N+2)x(N+2) 个网格点上的扩散系数（含边界点），必须为正
+    ArrayCoeff2D(const std::vector<double>& a, int N_, double hx_, double hy_)
+        : N(N_), hx(hx_), hy(hy_) {
+        const size_t n = (size_t)(N + 2) * (N + 2);
+        const double wx = 1.0 / (hx * hx);
+        const double wy = 1.0 / (hy * hy);
+        cx.assign(n, 0.0);
+        cy.assign(n, 0.0);
+        inv_d.assign(n, 0.0);
+        for (int i = 0; i <= N + 1; ++i) {
+            for (int j = 0; j <= N + 1; ++j) {
+                size_t p = (size_t)i * (N + 2) + j;
+                if (i <= N) cx[p] = wx * harmonic(a[p], a[p + N + 2]);
+                if (j <= N) cy[p] = wy * harmonic(a[p], a[p + 1]);
+            }
+        }
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                inv_d[idx(i, j)] = 1.0 / (xm(i, j) + xp(i, j) + ym(i, j) + yp(i, j));
+            }
+        }
+    }
+
+    size_t idx(int i, int j) const { return (size_t)i * (N + 2) + j; }
+    double xm(int i, int j) const { return cx[idx(i - 1, j)]; }
+    double xp(int i, int j) const { return cx[idx(i, j)]; }
+    double ym(int i, int j) const { return cy[idx(i, j - 1)]; }
+    double yp(int i, int j) const { return cy[idx(i, j)]; }
+    double inv_diag(int i, int j) const { return inv_d[idx(i, j)]; }
+
+    static double harmonic(double a, double b) { return 2.0 * a * b / (a + b); }
+};
+
+struct UnitCoeff3D {
+    double hx, hy, hz;
+    double wx, wy, wz;
+    double inv_d;
+    bool isotropic;
+
+    UnitCoeff3D(double hx_, double hy_, double hz_)
+        : hx(hx_), hy(hy_), hz(hz_), wx(1.0 / (hx_ * hx_)), wy(1.0 / (hy_ * hy_)), wz(1.0 / (hz_ * hz_)),
+          inv_d(1.0 / (2.0 * (wx + wy + wz))), isotropic(hx_ == hy_ && hy_ == hz_) {}
+
+    double xm(int, int, int) const { return wx; }
+    double xp(int, int, int) const { return wx; }
+    double ym(int, int, int) const { return wy; }
+    double yp(int, int, int) const { return wy; }
+    double zm(int, int, int) const { return wz; }
+    double zp(int, int, int) const { return wz; }
+    double inv_diag(int, int, int) const { return inv_d; }
+};
+
+struct ArrayCoeff3D {
+    int N;
+    double hx, hy, hz;
+    std::vector<double> cx, cy, cz;     // 点 p 与 +x / +y / +z 方向相邻点之间的面系数
+    std::vector<double> inv_d;
+
+    // a 为 (N+2)^3 个网格点上的扩散系数（含边界点），必须为正
+    ArrayCoeff3D(const std::vector<double>& a, int N_, double hx_, double hy_, double hz_)
+        : N(N_), hx(hx_), hy(hy_), hz(hz_) {
+        const size_t M = (size_t)(N + 2);
+        const size_t n = M * M * M;
+        const double wx = 1.0 / (hx * hx);
+        const double wy = 1.0 / (hy * hy);
+        const double wz = 1.0 / (hz * hz);
+        cx.assign(n, 0.0);
+        cy.assign(n, 0.0);
+        cz.assign(n, 0.0);
+        inv_d.assign(n, 0.0);
+        for (int i = 0; i <= N + 1; ++i) {
+            for (int j = 0; j <= N + 1; ++j) {
+                for (int k = 0; k <= N + 1; ++k) {
+                    size_t p = idx(i, j, k);
+                    if (i <= N) cx[p] = wx * ArrayCoeff2D::harmonic(a[p], a[p + M * M]);
+                    if (j <= N) cy[p] = wy * ArrayCoeff2D::harmonic(a[p], a[p + M]);
+                    if (k <= N) cz[p] = wz * ArrayCoeff2D::harmonic(a[p], a[p + 1]);
+                }
+            }
+        }
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                for (int k = 1; k <= N; ++k) {
+                    inv_d[idx(i, j, k)] = 1.0 / (xm(i, j, k) + xp(i, j, k) + ym(i, j, k) +
+                                                 yp(i, j, k) + zm(i, j, k) + zp(i, j, k));
+                }
+            }
+        }
+    }
+
+    size_t idx(int i, int j, int k) const { return ((size_t)i * (N + 2) + j) * (N + 2) + k; }
+    double xm(int i, int j, int k) const { return cx[idx(i - 1, j, k)]; }
+    double xp(int i, int j, int k) const { return cx[idx(i, j, k)]; }
+    double ym(int i, int j, int k) const { return cy[idx(i, j - 1, k)]; }
+    double yp(int i, int j, int k) const { return cy[idx(i, j, k)]; }
+    double zm(int i, int j, int k) const { return cz[idx(i, j, k - 1)]; }
+    double zp(int i, int j, int k) const { return cz[idx(i, j, k)]; }
+    double inv_diag(int i, int j, int k) const { return inv_d[idx(i, j, k)]; }
+};
+
+// ========== 行内核 ==========
+// 更新第 i 行 j ∈ [j_begin, j_end) 且 j % 2 == parity 的点；um / up 为第 i-1 / i+1 行，f 指向 N 宽的右端项行首
+
+template <class Coeff>
+struct StencilRow2D {
+    static void update(double* u, const double* um, const double* up, const double* f,
+                       const Coeff& c, int i, int j_begin, int j_end, int parity) {
+        for (int j = j_begin + ((j_begin + parity) & 1); j < j_end; j += 2) {
+            u[j] = c.inv_diag(i, j) * (f[j-1] + c.xm(i, j) * um[j] + c.xp(i, j) * up[j] +
+                                       c.ym(i, j) * u[j-1] + c.yp(i, j) * u[j+1]);
+        }
+    }
+};
+
+template <>
+struct StencilRow2D<UnitCoeff2D> {
+    static void update(double* u, const double* um, const double* up, const double* f,
+                       const UnitCoeff2D& c, int i, int j_begin, int j_end, int parity) {
+        // 与 *_tiled_aligned 同一个内核，结果逐位一致
+        if (c.isotropic) {
+            stencil_rb_row_2d(u, um, up, f, c.hx * c.hx, j_begin, j_end, parity);
+            return;
+        }
+        const double wx = c.wx, wy = c.wy, inv_d = c.inv_d;
+        (void)i;
+        for (int j = j_begin + ((j_begin + parity) & 1); j < j_end; j += 2) {
+            u[j] = inv_d * (f[j-1] + wx * (um[j] + up[j]) + wy * (u[j-1] + u[j+1]));
+        }
+    }
+};
+
+// 3D：更新 (i, j) 行 k ∈ [k_begin, k_end) 且 k % 2 == parity 的点
+template <class Coeff>
+struct StencilRow3D {
+    static void update(double* u, const double* im, const double* ip, const double* jm, const double* jp,
+                       const double* f, const Coeff& c, int i, int j, int k_begin, int k_end, int parity) {
+        for (int k = k_begin + ((k_begin + parity) & 1); k < k_end; k += 2) {
+            u[k] = c.inv_diag(i, j, k) * (f[k-1] + c.xm(i, j, k) * im[k] + c.xp(i, j, k) * ip[k] +
+                                          c.ym(i, j, k) * jm[k] + c.yp(i, j, k) * jp[k] +
+                                          c.zm(i, j, k) * u[k-1] + c.zp(i, j, k) * u[k+1]);
+        }
+    }
+};
+
+template <>
+struct StencilRow3D<UnitCoeff3D> {
+    static void update(double* u, const double* im, const double* ip, const double* jm, const double* jp,
+                       const double* f, const UnitCoeff3D& c, int i, int j, int k_begin, int k_end, int parity) {
+        // 与 *_tiled_aligned 同一个内核，结果逐位一致
+        if (c.isotropic) {
+            stencil_rb_row_3d(u, im, ip, jm, jp, f, c.hx * c.hx, k_begin, k_end, parity);
+            return;
+        }
+        const double wx = c.wx, wy = c.wy, wz = c.wz, inv_d = c.inv_d;
+        (void)i;
+        (void)j;
+        for (int k = k_begin + ((k_begin + parity) & 1); k < k_end; k += 2) {
+            u[k] = inv_d * (f[k-1] + wx * (im[k] + ip[k]) + wy * (jm[k] + jp[k]) + wz * (u[k-1] + u[k+1]));
+        }
+    }
+};
+
+// ========== 求解器 ==========
+
+template <class Coeff>
+class StencilGS2D {
+public:
+    // 按 Neumann 条件重写边界层（孤立的 omp for，带隐式 barrier；并行区外调用时串行执行）
+    static void fill_boundary(std::vector<double>& u, int N, const Coeff& c, const Boundary2D& bc) {
+        const size_t W = (size_t)(N + 2);
+        #pragma omp for schedule(static)
+        for (int t = 1; t <= N; ++t) {
+            if (bc.type[0] == BC_NEUMANN) u[t] = u[W + t] + c.hx * bc.g(0, t - 1);
+            if (bc.type[1] == BC_NEUMANN) u[(N + 1) * W + t] = u[N * W + t] + c.hx * bc.g(1, t - 1);
+            if (bc.type[2] == BC_NEUMANN) u[t * W] = u[t * W + 1] + c.hy * bc.g(2, t - 1);
+            if (bc.type[3] == BC_NEUMANN) u[t * W + N + 1] = u[t * W + N] + c.hy * bc.g(3, t - 1);
+        }
+    }
+
+    // 单色半次扫描，color = 0 为红点 (i+j)%2==0（孤立的 omp for nowait，调用方负责 barrier）
+    static void sweep_color(std::vector<double>& u, const std::vector<double>& f, int N,
+                            const Coeff& c, int tile_size, int color) {
+        #pragma omp for schedule(static) collapse(2) nowait
+        for (int bi = 1; bi <= N; bi += tile_size) {
+            for (int bj = 1; bj <= N; bj += tile_size) {
+                int i_end = std::min(bi + tile_size, N + 1);
+                int j_end = std::min(bj + tile_size, N + 1);
+                for (int i = bi; i < i_end; ++i) {
+                    StencilRow2D<Coeff>::update(&u[(size_t)i * (N + 2)], &u[(size_t)(i - 1) * (N + 2)],
+                                                &u[(size_t)(i + 1) * (N + 2)], &f[(size_t)(i - 1) * N],
+                                                c, i, bj, j_end, (i + color) % 2);
+                }
+            }
+        }
+    }
+
+    // 第 i 行的残差平方和
+    static double residual_row(const std::vector<double>& u, const std::vector<double>& f, int N,
+                               const Coeff& c, int i) {
+        double sum = 0.0;
+        for (int j = 1; j <= N; ++j) {
+            size_t p = (size_t)i * (N + 2) + j;
+            double au = c.xm(i, j) * (u[p] - u[p - N - 2]) + c.xp(i, j) * (u[p] - u[p + N + 2]) +
+                        c.ym(i, j) * (u[p] - u[p - 1]) + c.yp(i, j) * (u[p] - u[p + 1]);
+            double r = f[(size_t)(i - 1) * N + (j - 1)] - au;
+            sum += r * r;
+        }
+        return sum;
+    }
+
+    // ‖f - A u‖，边界层须已按 fill_boundary 更新
+    static double compute_residual(const std::vector<double>& u, const std::vector<double>& f, int N,
+                                   const Coeff& c) {
+        double sum = 0.0;
+        #pragma omp parallel for reduction(+:sum)
+        for (int i = 1; i <= N; ++i) {
+            sum += residual_row(u, f, N, c, i);
+        }
+        return std::sqrt(sum);
+    }
+
+    // 并行区内本线程分到的行的残差平方和（孤立的 omp for nowait，调用方负责 barrier）
+    static double residual_partial(const std::vector<double>& u, const std::vector<double>& f, int N,
+                                   const Coeff& c) {
+        double sum = 0.0;
+        #pragma omp for schedule(static) nowait
+        for (int i = 1; i <= N; ++i) {
+            sum += residual_row(u, f, N, c, i);
+        }
+        return sum;
+    }
+
+    // 收敛检查由 CheckSchedule 安排，返回时边界层已按 Neumann 条件更新
+    static void solve(std::vector<double>& u, const std::vector<double>& f, int N,
+                      const Coeff& c, const Boundary2D& bc,
+                      int max_iter, double tol, int& iter_count, double& residual,
+                      int num_threads = 4, CheckStats* stats = nullptr) {
+        const int tile_size = (N <= 128) ? 32 : 64;
+        const bool neumann = bc.has_neumann();
+        CheckSchedule schedule;
+        iter_count = 0;
+
+        // 残差由整个线程组计算，各线程的部分和按缓存行隔开
+        const int PAD = 8;  // 64 字节 / sizeof(double)
+        std::vector<double> partial((size_t)num_threads * PAD, 0.0);
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            const int tid = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            for (int iter = 0; iter < max_iter; ++iter) {
+                for (int color = 0; color < 2; ++color) {
+                    if (neumann) {
+                        fill_boundary(u, N, c, bc);
+                    }
+                    sweep_color(u, f, N, c, tile_size, color);
+                    #pragma omp barrier
+                }
+
+                // 与 solve_parallel_redblack 相同：next_check 在 single 之前的最后一个 barrier 之前读取
+                const int next_check = schedule.next_check();
+                #pragma omp barrier
+
+                if (iter + 1 == next_check) {
+                    // fill_boundary 和残差都是 omp for，不能嵌套在 single 里：所有线程先更新边界层、
+                    // 各自算分到的行的部分和，single 只做汇总和收敛判断（其结束处的 barrier 之后 partial 才会再被写）
+                    if (neumann) {
+                        fill_boundary(u, N, c, bc);
+                    }
+                    partial[tid * PAD] = residual_partial(u, f, N, c);
+                    #pragma omp barrier
+                    #pragma omp single
+                    {
+                        double sum = 0.0;
+                        for (int t = 0; t < nt; ++t) {
+                            sum += partial[t * PAD];
+                        }
+                        residual = std::sqrt(sum);
+                        schedule.update(residual, iter + 1, tol);
+                        if (residual < tol) {
+                            iter_count = iter + 1;
+                            max_iter = iter;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (iter_count == 0) {
+            if (neumann) {
+                fill_boundary(u, N, c, bc);
+            }
+            residual = compute_residual(u, f, N, c);
+            iter_count = max_iter;
+        }
+        if (stats) {
+            *stats = schedule.stats();
+        }
+    }
+};
+
+template <class Coeff>
+class StencilGS3D {
+public:
+    static void fill_boundary(std::vector<double>& u, int N, const Coeff& c, const Boundary3D& bc) {
+        const size_t W = (size_t)(N + 2);
+        const size_t P = W * W;
+        #pragma omp for schedule(static) collapse(2)
+        for (int a = 1; a <= N; ++a) {
+            for (int b = 1; b <= N; ++b) {
+                // x 面：(j, k) = (a, b)；y 面：(i, k) = (a, b)；z 面：(i, j) = (a, b)
+                if (bc.type[0] == BC_NEUMANN) u[a * W + b] = u[P + a * W + b] + c.hx * bc.g(0, a - 1, b - 1, N);
+                if (bc.type[1] == BC_NEUMANN) u[(N + 1) * P + a * W + b] = u[N * P + a * W + b] + c.hx * bc.g(1, a - 1, b - 1, N);
+                if (bc.type[2] == BC_NEUMANN) u[a * P + b] = u[a * P + W + b] + c.hy * bc.g(2, a - 1, b - 1, N);
+                if (bc.type[3] == BC_NEUMANN) u[a * P + (N + 1) * W + b] = u[a * P + N * W + b] + c.hy * bc.g(3, a - 1, b - 1, N);
+                if (bc.type[4] == BC_NEUMANN) u[a * P + b * W] = u[a * P + b * W + 1] + c.hz * bc.g(4, a - 1, b - 1, N);
+                if (bc.type[5] == BC_NEUMANN) u[a * P + b * W + N + 1] = u[a * P + b * W + N] + c.hz * bc.g(5, a - 1, b - 1, N);
+            }
+        }
+    }
+
+    static void sweep_color(std::vector<double>& u, const std::vector<double>& f, int N,
+                            const Coeff& c, int tile_size, int color) {
+        const size_t W = (size_t)(N + 2);
+        #pragma omp for schedule(static) collapse(3) nowait
+        for (int bi = 1; bi <= N; bi += tile_size) {
+            for (int bj = 1; bj <= N; bj += tile_size) {
+                for (int bk = 1; bk <= N; bk += tile_size) {
+                    int i_end = std::min(bi + tile_size, N + 1);
+                    int j_end = std::min(bj + tile_size, N + 1);
+                    int k_end = std::min(bk + tile_size, N + 1);
+                    for (int i = bi; i < i_end; ++i) {
+                        for (int j = bj; j < j_end; ++j) {
+                            double* row = &u[((size_t)i * W + j) * W];
+                            StencilRow3D<Coeff>::update(row, row - W * W, row + W * W, row - W, row + W,
+                                                        &f[((size_t)(i - 1) * N + (j - 1)) * N],
+                                                        c, i, j, bk, k_end, (i + j + color) % 2);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // (i, j) 这一行（沿 k）的残差平方和
+    static double residual_row(const std::vector<double>& u, const std::vector<double>& f, int N,
+                               const Coeff& c, int i, int j) {
+        const size_t W = (size_t)(N + 2);
+        double sum = 0.0;
+        for (int k = 1; k <= N; ++k) {
+            size_t p = ((size_t)i * W + j) * W + k;
+            double au = c.xm(i, j, k) * (u[p] - u[p - W * W]) + c.xp(i, j, k) * (u[p] - u[p + W * W]) +
+                        c.ym(i, j, k) * (u[p] - u[p - W]) + c.yp(i, j, k) * (u[p] - u[p + W]) +
+                        c.zm(i, j, k) * (u[p] - u[p - 1]) + c.zp(i, j, k) * (u[p] - u[p + 1]);
+            double r = f[((size_t)(i - 1) * N + (j - 1)) * N + (k - 1)] - au;
+            sum += r * r;
+        }
+        return sum;
+    }
+
+    static double compute_residual(const std::vector<double>& u, const std::vector<double>& f, int N,
+                                   const Coeff& c) {
+        double sum = 0.0;
+        #pragma omp parallel for collapse(2) reduction(+:sum)
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                sum += residual_row(u, f, N, c, i, j);
+            }
+        }
+        return std::sqrt(sum);
+    }
+
+    // 并行区内本线程分到的行的残差平方和（孤立的 omp for nowait，调用方负责 barrier）
+    static double residual_partial(const std::vector<double>& u, const std::vector<double>& f, int N,
+                                   const Coeff& c) {
+        double sum = 0.0;
+        #pragma omp for schedule(static) collapse(2) nowait
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                sum += residual_row(u, f, N, c, i, j);
+            }
+        }
+        return sum;
+    }
+
+    static void solve(std::vector<double>& u, const std::vector<double>& f, int N,
+                      const Coeff& c, const Boundary3D& bc,
+                      int max_iter, double tol, int& iter_count, double& residual,
+                      int num_threads = 8, CheckStats* stats = nullptr) {
+        const int tile_size = (N <= 64) ? 16 : 32;
+        const bool neumann = bc.has_neumann();
+        CheckSchedule schedule;
+        iter_count = 0;
+
+        // 残差由整个线程组计算，各线程的部分和按缓存行隔开
+        const int PAD = 8;  // 64 字节 / sizeof(double)
+        std::vector<double> partial((size_t)num_threads * PAD, 0.0);
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+            const int tid = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            for (int iter = 0; iter < max_iter; ++iter) {
+                for (int color = 0; color < 2; ++color) {
+                    if (neumann) {
+                        fill_boundary(u, N, c, bc);
+                    }
+                    sweep_color(u, f, N, c, tile_size, color);
+                    #pragma omp barrier
+                }
+
+                const int next_check = schedule.next_check();
+                #pragma omp barrier
+
+                if (iter + 1 == next_check) {
+                    // fill_boundary 和残差都是 omp for，不能嵌套在 single 里：所有线程先更新边界层、
+                    // 各自算分到的行的部分和，single 只做汇总和收敛判断（其结束处的 barrier 之后 partial 才会再被写）
+                    if (neumann) {
+                        fill_boundary(u, N, c, bc);
+                    }
+                    partial[tid * PAD] = residual_partial(u, f, N, c);
+                    #pragma omp barrier
+                    #pragma omp single
+                    {
+                        double sum = 0.0;
+                        for (int t = 0; t < nt; ++t) {
+                            sum += partial[t * PAD];
+                        }
+                        residual = std::sqrt(sum);
+                        schedule.update(residual, iter + 1, tol);
+                        if (residual < tol) {
+                            iter_count = iter + 1;
+                            max_iter = iter;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (iter_count == 0) {
+            if (neumann) {
+                fill_boundary(u, N, c, bc);
+            }
+            residual = compute_residual(u, f, N, c);
+            iter_count = max_iter;
+        }
+        if (stats) {
+            *stats = schedule.stats();
+        }
+    }
+};
+
+#endif // STENCIL_OPERATOR_H
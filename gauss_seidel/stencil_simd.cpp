@@ -0,0 +1,275 @@
+#include "stencil_simd.h"
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STENCIL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*Row2DFn)(double*, const double*, const double*, const double*,
+                        double, int, int, int);
+typedef void (*Row3DFn)(double*, const double*, const double*, const double*, const double*,
+                        const double*, double, int, int, int);
+
+// 不小于 j 且 j % 2 == parity 的第一个下标
+inline int first_of_parity(int j, int parity) {
+    return j + ((j + parity) & 1);
+}
+
+// ========== 标量版本 ==========
+
+void row_2d_scalar(double* u, const double* up, const double* down, const double* f,
+                   double h2, int j_begin, int j_end, int parity) {
+    for (int j = first_of_parity(j_begin, parity); j < j_end; j += 2) {
+        u[j] = 0.25 * (up[j] + down[j] + u[j-1] + u[j+1] + h2 * f[j-1]);
+    }
+}
+
+void row_3d_scalar(double* u, const double* im, const double* ip, const double* jm, const double* jp,
+                   const double* f, double h2, int k_begin, int k_end, int parity) {
+    const double inv6 = 1.0 / 6.0;
+    for (int k = first_of_parity(k_begin, parity); k < k_end; k += 2) {
+        u[k] = inv6 * (im[k] + ip[k] + jm[k] + jp[k] + u[k-1] + u[k+1] + h2 * f[k-1]);
+    }
+}
+
+#ifdef STENCIL_X86
+
+// ========== AVX2 + FMA ==========
+// 向量从第一个本颜色的点开始，本颜色固定在通道 0、2，只写回这两个通道。
+// right 是下标 j+1..j+4 的载入，left 只用到通道 0、2（u[j-1]、u[j+1]），由上一次的 right
+// 和本次的 right 拼出，不重新载入刚被掩码存储覆盖的地址（否则存储转发失败，比标量还慢）。
+// 本行 u 的访问都在 [j_begin - 1, j_end) 内；尾部交给标量版本。
+// 注意：up / down（3D 为 im / ip / jm / jp）整段载入，其中奇数通道是本颜色的点，可能属于同一个半扫描中由别的线程
+// 正在更新的相邻块，读到的值不确定。这些通道只进入被掩码丢弃的结果通道，不影响写回的点，
+// 修改掩码或通道布局时不能依赖它们的值
+
+__attribute__((target("avx2,fma")))
+void row_2d_avx2(double* u, const double* up, const double* down, const double* f,
+                 double h2, int j_begin, int j_end, int parity) {
+    const __m256d quarter = _mm256_set1_pd(0.25);
+    const __m256d vh2 = _mm256_set1_pd(h2);
+    const __m256i mask = _mm256_set_epi64x(0, -1, 0, -1);
+
+    int j = first_of_parity(j_begin, parity);
+    if (j + 5 <= j_end) {
+        __m256d left = _mm256_loadu_pd(u + j - 1);
+        __m256d right = _mm256_loadu_pd(u + j + 1);
+        for (;;) {
+            __m256d s = _mm256_add_pd(_mm256_loadu_pd(up + j), _mm256_loadu_pd(down + j));
+            s = _mm256_add_pd(s, left);
+            s = _mm256_add_pd(s, right);
+            s = _mm256_fmadd_pd(vh2, _mm256_loadu_pd(f + j - 1), s);
+            _mm256_maskstore_pd(u + j, mask, _mm256_mul_pd(quarter, s));
+
+            j += 4;
+            if (j + 5 > j_end) {
+                break;
+            }
+            __m256d next = _mm256_loadu_pd(u + j + 1);
+            left = _mm256_permute2f128_pd(right, next, 0x21);
+            right = next;
+        }
+    }
+    row_2d_scalar(u, up, down, f, h2, j, j_end, parity);
+}
+
+__attribute__((target("avx2,fma")))
+void row_3d_avx2(double* u, const double* im, const double* ip, const double* jm, const double* jp,
+                 const double* f, double h2, int k_begin, int k_end, int parity) {
+    const __m256d inv6 = _mm256_set1_pd(1.0 / 6.0);
+    const __m256d vh2 = _mm256_set1_pd(h2);
+    const __m256i mask = _mm256_set_epi64x(0, -1, 0, -1);
+
+    int k = first_of_parity(k_begin, parity);
+    if (k + 5 <= k_end) {
+        __m256d left = _mm256_loadu_pd(u + k - 1);
+        __m256d right = _mm256_loadu_pd(u + k + 1);
+        for (;;) {
+            __m256d s = _mm256_add_pd(_mm256_loadu_pd(im + k), _mm256_loadu_pd(ip + k));
+            s = _mm256_add_pd(s, _mm256_loadu_pd(jm + k));
+            s = _mm256_add_pd(s, _mm256_loadu_pd(jp + k));
+            s = _mm256_add_pd(s, left);
+            s = _mm256_add_pd(s, right);
+            s = _mm256_fmadd_pd(vh2, _mm256_loadu_pd(f + k - 1), s);
+            _mm256_maskstore_pd(u + k, mask, _mm256_mul_pd(inv6, s));
+
+            k += 4;
+            if (k + 5 > k_end) {
+                break;
+            }
+            __m256d next = _mm256_loadu_pd(u + k + 1);
+            left = _mm256_permute2f128_pd(right, next, 0x21);
+            right = next;
+        }
+    }
+    row_3d_scalar(u, im, ip, jm, jp, f, h2, k, k_end, parity);
+}
+
+// ========== AVX-512F ==========
+// 同样的做法，每次 8 个点，本颜色为偶数通道；left 由 valignq 从上一次和本次的 right 拼出
+
+__attribute__((target("avx512f")))
+inline __m512d shift_in_avx512(__m512d prev, __m512d next) {
+    // [prev6, prev7, next0, ..., next5]
+    return _mm512_castsi512_pd(_mm512_alignr_epi64(_mm512_castpd_si512(next),
+                                                   _mm512_castpd_si512(prev), 6));
+}
+
+__attribute__((target("avx512f")))
+void row_2d_avx512(double* u, const double* up, const double* down, const double* f,
+                   double h2, int j_begin, int j_end, int parity) {
+    const __m512d quarter = _mm512_set1_pd(0.25);
+    const __m512d vh2 = _mm512_set1_pd(h2);
+    const __mmask8 colour = 0x55;
+
+    int j = first_of_parity(j_begin, parity);
+    if (j + 9 <= j_end) {
+        __m512d left = _mm512_loadu_pd(u + j - 1);
+        __m512d right = _mm512_loadu_pd(u + j + 1);
+        for (;;) {
+            __m512d s = _mm512_add_pd(_mm512_loadu_pd(up + j), _mm512_loadu_pd(down + j));
+            s = _mm512_add_pd(s, left);
+            s = _mm512_add_pd(s, right);
+            s = _mm512_fmadd_pd(vh2, _mm512_loadu_pd(f + j - 1), s);
+            _mm512_mask_storeu_pd(u + j, colour, _mm512_mul_pd(quarter, s));
+
+            j += 8;
+            if (j + 9 > j_end) {
+                break;
+            }
+            __m512d next = _mm512_loadu_pd(u + j + 1);
+            left = shift_in_avx512(right, next);
+            right = next;
+        }
+    }
+    row_2d_scalar(u, up, down, f, h2, j, j_end, parity);
+}
+
+__attribute__((target("avx512f")))
+void row_3d_avx512(double* u, const double* im, const double* ip, const double* jm, const double* jp,
+                   const double* f, double h2, int k_begin, int k_end, int parity) {
+    const __m512d inv6 = _mm512_set1_pd(1.0 / 6.0);
+    const __m512d vh2 = _mm512_set1_pd(h2);
+    const __mmask8 colour = 0x55;
+
+    int k = first_of_parity(k_begin, parity);
+    if (k + 9 <= k_end) {
+        __m512d left = _mm512_loadu_pd(u + k - 1);
+        __m512d right = _mm512_loadu_pd(u + k + 1);
+        for (;;) {
+            __m512d s = _mm512_add_pd(_mm512_loadu_pd(im + k), _mm512_loadu_pd(ip + k));
+            s = _mm512_add_pd(s, _mm512_loadu_pd(jm + k));
+            s = _mm512_add_pd(s, _mm512_loadu_pd(jp + k));
+            s = _mm512_add_pd(s, left);
+            s = _mm512_add_pd(s, right);
+            s = _mm512_fmadd_pd(vh2, _mm512_loadu_pd(f + k - 1), s);
+            _mm512_mask_storeu_pd(u + k, colour, _mm512_mul_pd(inv6, s));
+
+            k += 8;
+            if (k + 9 > k_end) {
+                break;
+            }
+            __m512d next = _mm512_loadu_pd(u + k + 1);
+            left = shift_in_avx512(right, next);
+            right = next;
+        }
+    }
+    row_3d_scalar(u, im, ip, jm, jp, f, h2, k, k_end, parity);
+}
+
+#endif // STENCIL_X86
+
+StencilISA detect_isa() {
+    StencilISA best = STENCIL_SCALAR;
+#ifdef STENCIL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        best = STENCIL_AVX2;
+        if (__builtin_cpu_supports("avx512f")) {
+            best = STENCIL_AVX512;
+        }
+    }
+#endif
+
+    // 只允许向下限制，不能强制使用 CPU 不支持的指令集
+    const char* env = std::getenv("GS_STENCIL_ISA");
+    if (env) {
+        StencilISA limit = best;
+        if (std::strcmp(env, "scalar") == 0) {
+            limit = STENCIL_SCALAR;
+        } else if (std::strcmp(env, "avx2") == 0) {
+            limit = STENCIL_AVX2;
+        }
+        if (limit < best) {
+            best = limit;
+        }
+    }
+    return best;
+}
+
+Row2DFn select_row_2d(StencilISA isa) {
+#ifdef STENCIL_X86
+    if (isa == STENCIL_AVX512) return row_2d_avx512;
+    if (isa == STENCIL_AVX2) return row_2d_avx2;
+#endif
+    (void)isa;
+    return row_2d_scalar;
+}
+
+Row3DFn select_row_3d(StencilISA isa) {
+#ifdef STENCIL_X86
+    if (isa == STENCIL_AVX512) return row_3d_avx512;
+    if (isa == STENCIL_AVX2) return row_3d_avx2;
+#endif
+    (void)isa;
+    return row_3d_scalar;
+}
+
+} // namespace
+
+StencilISA stencil_isa() {
+    static const StencilISA isa = detect_isa();
+    return isa;
+}
+
+const char* stencil_isa_name(StencilISA isa) {
+    switch (isa) {
+    case STENCIL_AVX512: return "avx512";
+    case STENCIL_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+void stencil_rb_row_2d(
+    double* u,
+    const double* up,
+    const double* down,
+    const double* f,
+    double h2,
+    int j_begin,
+    int j_end,
+    int parity
+) {
+    static const Row2DFn fn = select_row_2d(stencil_isa());
+    fn(u, up, down, f, h2, j_begin, j_end, parity);
+}
+
+void stencil_rb_row_3d(
+    double* u,
+    const double* im,
+    const double* ip,
+    const double* jm,
+    const double* jp,
+    const double* f,
+    double h2,
+    int k_begin,
+    int k_end,
+    int parity
+) {
+    static const Row3DFn fn = select_row_3d(stencil_isa());
+    fn(u, im, ip, jm, jp, f, h2, k_begin, k_end, parity);
+}
@@ -0,0 +1,55 @@
+#ifndef STENCIL_SIMD_H
+#define STENCIL_SIMD_H
+
+// 红黑 Gauss-Seidel 的手写 SIMD 行内核（交错存储），运行时按 CPU 选择 AVX-512 / AVX2+FMA / 标量
+//
+// 交错存储中同色点相隔一个元素，标量循环 j += 2 编译器基本不向量化。这里的内核按连续向量
+// 载入整段行（AVX2 4 个点、AVX-512 8 个点），对所有通道计算 (邻居之和 + h^2 f) / 4（3D 为 / 6，
+// h^2 f 用 FMA 融合进邻居之和），再用掩码存储只写回本颜色的通道：
+// 一半通道的运算是多余的，但载入和存储都是单位步长，不需要 gather，
+// 被更新的点只依赖另一种颜色的点，同一向量内先载入后存储不影响结果。
+// 只有 GCC / Clang 的 x86 目标编译向量版本（target 属性），其他平台只有标量版本。
+//
+// 环境变量 GS_STENCIL_ISA=scalar|avx2|avx512 可以把选择限制到较低的指令集，用于对比。
+
+enum StencilISA {
+    STENCIL_SCALAR,
+    STENCIL_AVX2,       // AVX2 + FMA
+    STENCIL_AVX512      // AVX-512F
+};
+
+// 第一次调用时检测 CPU，之后返回缓存的结果
+StencilISA stencil_isa();
+
+const char* stencil_isa_name(StencilISA isa);
+
+// 2D 行内核：更新 j ∈ [j_begin, j_end) 且 j % 2 == parity 的点
+//   u[j] = 0.25 * (up[j] + down[j] + u[j-1] + u[j+1] + h2 * f[j-1])
+// u / up / down 指向 (N+2) 宽的行首（含边界列），f 指向 N 宽的右端项行首
+void stencil_rb_row_2d(
+    double* u,
+    const double* up,
+    const double* down,
+    const double* f,
+    double h2,
+    int j_begin,
+    int j_end,
+    int parity
+);
+
+// 3D 行内核：更新 k ∈ [k_begin, k_end) 且 k % 2 == parity 的点
+//   u[k] = (im[k] + ip[k] + jm[k] + jp[k] + u[k-1] + u[k+1] + h2 * f[k-1]) / 6
+void stencil_rb_row_3d(
+    double* u,
+    const double* im,
+    const double* ip,
+    const double* jm,
+    const double* jp,
+    const double* f,
+    double h2,
+    int k_begin,
+    int k_end,
+    int parity
+);
+
+#endif // STENCIL_SIMD_H
@@ -1,5 +1,5 @@
 # ڴŻԽű
-# OriginalTiledTiled+Aligned汾
+# OriginalFused RBڵɨۼƲвTiledTiled+Alignedʱֿ飨Temporalڷ洢Split RBϾȣMixed FP32ͨģӣStencil Unit / Array汾Լ SORCG / PCG ͶV/W/FMG
 Set-Location -Path $PSScriptRoot
 Write-Host "========== Memory Alignment Optimization Batch Test ==========" -ForegroundColor Cyan
 Write-Host "Compiling test programs..." -ForegroundColor Yellow
@@ -10,6 +10,11 @@ g++ -O2 -march=native -fopenmp `
     gauss_seidel_2d.cpp `
     gauss_seidel_2d_tiled.cpp `
     gauss_seidel_2d_tiled_aligned.cpp `
+    multigrid_2d.cpp `
+    pcg_2d.cpp `
+    stencil_simd.cpp `
+    redblack_split_2d.cpp `
+    mixed_precision_2d.cpp `
     test_tiled_aligned_2d.cpp `
     -o test_aligned_2d.exe
 
@@ -24,6 +29,11 @@ g++ -O2 -march=native -fopenmp `
     gauss_seidel_3d.cpp `
     gauss_seidel_3d_tiled.cpp `
     gauss_seidel_3d_tiled_aligned.cpp `
+    multigrid_3d.cpp `
+    pcg_3d.cpp `
+    stencil_simd.cpp `
+    redblack_split_3d.cpp `
+    mixed_precision_3d.cpp `
     test_tiled_aligned_3d.cpp `
     -o test_aligned_3d.exe
 
@@ -59,7 +69,7 @@ foreach ($N in $sizes_2d) {
         # 
         $lines = $output -split "`n"
         foreach ($line in $lines) {
-            if ($line -match '(Original|Tiled|Tiled\+Aligned)\s+\|\s+(\d+)\s+\|\s+([\d.]+)\s+\|\s+([\d.e+-]+)\s+\|\s+([\d.]+)x') {
+            if ($line -match '(Original|Fused RB|Tiled|Tiled\+Aligned|Temporal|Split RB|Mixed FP32|Stencil Unit|Stencil Array|SOR RB \(auto\)|SOR RB|PCG-SGS|CG|Multigrid V|Multigrid W|Multigrid FMG)\s+\|\s+(\d+)\s+\|\s+([\d.]+)\s+\|\s+([\d.e+-]+)\s+\|\s+([\d.]+)x') {
                 $method = $matches[1]
                 $iters = $matches[2]
                 $time = $matches[3]
@@ -75,8 +85,15 @@ foreach ($N in $sizes_2d) {
                     Time_ms = $time
                     Error = $err_val
                     Speedup = $speedup
+                    GFLOPS = ""
+                    Roofline_pct = ""
                 }
             }
+            elseif ($line -match 'Roofline:\s+([\d.]+) GFLOP/s,\s+([\d.]+)% of' -and $results_2d.Count -gt 0) {
+                # ɨ跽һУʵ GFLOP/s ռڴݶߵı
+                $results_2d[-1].GFLOPS = $matches[1]
+                $results_2d[-1].Roofline_pct = $matches[2]
+            }
         }
         
         Write-Host " - Done" -ForegroundColor Gray
@@ -98,7 +115,7 @@ foreach ($N in $sizes_3d) {
         # 
         $lines = $output -split "`n"
         foreach ($line in $lines) {
-            if ($line -match '(Original|Tiled|Tiled\+Aligned)\s+\|\s+(\d+)\s+\|\s+([\d.]+)\s+\|\s+([\d.e+-]+)\s+\|\s+([\d.]+)x') {
+            if ($line -match '(Original|Fused RB|Tiled|Tiled\+Aligned|Temporal|Split RB|Mixed FP32|Stencil Unit|Stencil Array|SOR RB \(auto\)|SOR RB|PCG-SGS|CG|Multigrid V|Multigrid W|Multigrid FMG)\s+\|\s+(\d+)\s+\|\s+([\d.]+)\s+\|\s+([\d.e+-]+)\s+\|\s+([\d.]+)x') {
                 $method = $matches[1]
                 $iters = $matches[2]
                 $time = $matches[3]
@@ -114,8 +131,15 @@ foreach ($N in $sizes_3d) {
                     Time_ms = $time
                     Error = $err_val
                     Speedup = $speedup
+                    GFLOPS = ""
+                    Roofline_pct = ""
                 }
             }
+            elseif ($line -match 'Roofline:\s+([\d.]+) GFLOP/s,\s+([\d.]+)% of' -and $results_3d.Count -gt 0) {
+                # ɨ跽һУʵ GFLOP/s ռڴݶߵı
+                $results_3d[-1].GFLOPS = $matches[1]
+                $results_3d[-1].Roofline_pct = $matches[2]
+            }
         }
         
         Write-Host " - Done" -ForegroundColor Gray
@@ -142,10 +166,10 @@ foreach ($N in $sizes_2d) {
     Write-Host "----------------------------------------------------------------------"
     Write-Host "Թģ: ${N}x${N}"
     Write-Host "----------------------------------------------------------------------"
-    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}" -f "", "ʱ(ms)", "ٱ", "Ч(%)")
-    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}" -f "--------------------", "-----------", "--------", "--------")
+    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}   {4,12}" -f "", "ʱ(ms)", "ٱ", "Ч(%)", "Roofline(%)")
+    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}   {4,12}" -f "--------------------", "-----------", "--------", "--------", "------------")
     
-    foreach ($method in @("Original", "Tiled", "Tiled+Aligned")) {
+    foreach ($method in @("Original", "Fused RB", "Tiled", "Tiled+Aligned", "Temporal", "Split RB", "Mixed FP32", "Stencil Unit", "Stencil Array", "SOR RB", "SOR RB (auto)", "CG", "PCG-SGS", "Multigrid V", "Multigrid W", "Multigrid FMG")) {
         $method_data = $results_2d | Where-Object { $_.N -eq $N -and $_.Method -eq $method } | Sort-Object { [int]$_.Threads }
         
         if ($method_data.Count -gt 0) {
@@ -159,8 +183,10 @@ foreach ($N in $sizes_2d) {
                 
                 $speedup_str = if ($speedup -ge 1) { "{0:F2}x" -f $speedup } else { "{0:F2}x" -f $speedup }
                 
-                Write-Host ("{0,-20}  {1,11:F2}   {2,8}   {3,7:F1}%" -f `
-                    "$($row.Threads) ߳", $time, $speedup_str, $efficiency)
+                $roofline_str = if ($row.Roofline_pct) { "$($row.Roofline_pct)%" } else { "-" }
+                
+                Write-Host ("{0,-20}  {1,11:F2}   {2,8}   {3,7:F1}%   {4,12}" -f `
+                    "$($row.Threads) ߳", $time, $speedup_str, $efficiency, $roofline_str)
             }
             Write-Host ""
         }
@@ -176,10 +202,10 @@ foreach ($N in $sizes_3d) {
     Write-Host "----------------------------------------------------------------------"
     Write-Host "Թģ: ${N}x${N}x${N}"
     Write-Host "----------------------------------------------------------------------"
-    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}" -f "", "ʱ(ms)", "ٱ", "Ч(%)")
-    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}" -f "--------------------", "-----------", "--------", "--------")
+    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}   {4,12}" -f "", "ʱ(ms)", "ٱ", "Ч(%)", "Roofline(%)")
+    Write-Host ("{0,-20}  {1,11}   {2,8}   {3,8}   {4,12}" -f "--------------------", "-----------", "--------", "--------", "------------")
     
-    foreach ($method in @("Original", "Tiled", "Tiled+Aligned")) {
+    foreach ($method in @("Original", "Fused RB", "Tiled", "Tiled+Aligned", "Temporal", "Split RB", "Mixed FP32", "Stencil Unit", "Stencil Array", "SOR RB", "SOR RB (auto)", "CG", "PCG-SGS", "Multigrid V", "Multigrid W", "Multigrid FMG")) {
         $method_data = $results_3d | Where-Object { $_.N -eq $N -and $_.Method -eq $method } | Sort-Object { [int]$_.Threads }
         
         if ($method_data.Count -gt 0) {
@@ -193,8 +219,10 @@ foreach ($N in $sizes_3d) {
                 
                 $speedup_str = if ($speedup -ge 1) { "{0:F2}x" -f $speedup } else { "{0:F2}x" -f $speedup }
                 
-                Write-Host ("{0,-20}  {1,11:F2}   {2,8}   {3,7:F1}%" -f `
-                    "$($row.Threads) ߳", $time, $speedup_str, $efficiency)
+                $roofline_str = if ($row.Roofline_pct) { "$($row.Roofline_pct)%" } else { "-" }
+                
+                Write-Host ("{0,-20}  {1,11:F2}   {2,8}   {3,7:F1}%   {4,12}" -f `
+                    "$($row.Threads) ߳", $time, $speedup_str, $efficiency, $roofline_str)
             }
             Write-Host ""
         }
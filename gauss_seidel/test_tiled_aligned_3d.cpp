@@ -1,8 +1,19 @@
 #include "gauss_seidel_3d.h"
+#include "multigrid.h"
+#include "pcg.h"
+#include "mixed_precision.h"
+#include "redblack_split.h"
+#include "stencil_operator.h"
+#include "stencil_simd.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <string>
+#include <random>
+#include "../common/perf_counters.h"
+#include "../common/roofline.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -22,7 +33,23 @@ namespace GaussSeidel3DTiled {
         double tol,
         int& iter_count,
         double& residual,
-        int num_threads
+        int num_threads,
+        CheckStats* stats = nullptr
+    );
+
+    // ʱֿ汾ÿα time_block ε0 ΪĬֵ
+    void solve_temporal_tiling(
+        std::vector<double>& u,
+        const std::vector<double>& f,
+        int N,
+        double h,
+        int max_iter,
+        double tol,
+        int& iter_count,
+        double& residual,
+        int num_threads,
+        int time_block,
+        CheckStats* stats = nullptr
     );
 }
 
@@ -37,7 +64,8 @@ namespace GaussSeidel3DTiledAligned {
         double tol,
         int& iter_count,
         double& residual,
-        int num_threads
+        int num_threads,
+        CheckStats* stats = nullptr
     );
 }
 
@@ -61,6 +89,103 @@ double compute_error(const vector<double>& u, const vector<double>& u_exact, int
     return sqrt(error / norm);
 }
 
+// ϵģӣ-div(a grad u) = fa = 1 + x + y^2 + zu = sin(pi x) sin(pi y) exp(-z)
+// hz = 2 hx = 2 hy [0,1]^2 x [0,2]neumann Ϊ true ʱ z = 0  du/dn = -du/dz = sin(pi x) sin(pi y)
+// Ϊ Dirichlet⵽ԶСɢ뾫ȷ
+double manufactured_error_3d(int N, bool neumann, int num_threads, int& iter_count) {
+    const double pi = 3.14159265358979323846;
+    const double h = 1.0 / (N + 1);
+    const double hz = 2.0 * h;
+    const int W = N + 2;
+    const size_t P = (size_t)W * W;
+    
+    vector<double> a(P * W), u(P * W, 0.0), u_exact(P * W), f((size_t)N * N * N);
+    for (int i = 0; i < W; ++i) {
+        for (int j = 0; j < W; ++j) {
+            for (int k = 0; k < W; ++k) {
+                double x = i * h, y = j * h, z = k * hz;
+                a[i * P + j * W + k] = 1.0 + x + y * y + z;
+                u_exact[i * P + j * W + k] = sin(pi * x) * sin(pi * y) * exp(-z);
+            }
+        }
+    }
+    double f_norm = 0.0;
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                double x = i * h, y = j * h, z = k * hz;
+                double ue = u_exact[i * P + j * W + k];
+                double ux = pi * cos(pi * x) * sin(pi * y) * exp(-z);
+                double uy = pi * sin(pi * x) * cos(pi * y) * exp(-z);
+                // f = -(a_x u_x + a_y u_y + a_z u_z + a u)u = (1 - 2 pi^2) uu_z = -u
+                double fv = -ux - 2.0 * y * uy + ue + (1.0 + x + y * y + z) * (2.0 * pi * pi - 1.0) * ue;
+                f[((size_t)(i - 1) * N + (j - 1)) * N + (k - 1)] = fv;
+                f_norm += fv * fv;
+            }
+        }
+    }
+    
+    // Dirichlet ı߽ȡȷֵNeumann ı߽д
+    for (int i = 0; i < W; ++i) {
+        for (int j = 0; j < W; ++j) {
+            for (int k = 0; k < W; ++k) {
+                if (i == 0 || i == N + 1 || j == 0 || j == N + 1 || k == 0 || k == N + 1) {
+                    u[i * P + j * W + k] = u_exact[i * P + j * W + k];
+                }
+            }
+        }
+    }
+    Boundary3D bc;
+    if (neumann) {
+        bc.type[4] = BC_NEUMANN;
+        bc.flux[4].resize((size_t)N * N);
+        for (int i = 1; i <= N; ++i) {
+            for (int j = 1; j <= N; ++j) {
+                bc.flux[4][(i - 1) * N + (j - 1)] = sin(pi * i * h) * sin(pi * j * h);
+            }
+        }
+    }
+    
+    ArrayCoeff3D coeff(a, N, h, h, hz);
+    double residual = 0.0;
+    StencilGS3D<ArrayCoeff3D>::solve(u, f, N, coeff, bc, 400000, 1e-10 * sqrt(f_norm),
+                                     iter_count, residual, num_threads);
+    
+    double err = 0.0;
+    for (int i = 1; i <= N; ++i) {
+        for (int j = 1; j <= N; ++j) {
+            for (int k = 1; k <= N; ++k) {
+                err = max(err, fabs(u[i * P + j * W + k] - u_exact[i * P + j * W + k]));
+            }
+        }
+    }
+    return err;
+}
+
+// Ҷ̶ӣ SOR Ѳвʼֵ 1e-6 ĵȫƵʣ
+// ҪϾò֣Ӧ  Ȱ h ֵ
+int sor_random_rhs_iterations(int N, double omega, bool parallel, int num_threads) {
+    const double h = 1.0 / (N + 1);
+    const int W = N + 2;
+    
+    vector<double> u((size_t)W * W * W, 0.0), f((size_t)N * N * N);
+    mt19937 gen(20240607);
+    uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t t = 0; t < f.size(); ++t) {
+        f[t] = dist(gen);
+    }
+    double tol = 1e-6 * GaussSeidel3D::compute_residual(u, f, N, h);
+    
+    int iter_count = 0;
+    double residual = 0.0;
+    if (parallel) {
+        GaussSeidel3D::solve_parallel_redblack_sor(u, f, N, h, 1000000, tol, iter_count, residual, num_threads, omega);
+    } else {
+        GaussSeidel3D::solve_serial_sor(u, f, N, h, 1000000, tol, iter_count, residual, omega);
+    }
+    return iter_count;
+}
+
 int main(int argc, char* argv[]) {
     // Windows̨ΪUTF-8
     #ifdef _WIN32
@@ -70,12 +195,17 @@ int main(int argc, char* argv[]) {
     
     // в
     if (argc < 3) {
-        cout << "÷: " << argv[0] << " <N> <߳>" << endl;
+        cout << "÷: " << argv[0] << " <N> <߳> [--serial]" << endl;
         return 1;
     }
     
+    // Ӳ OpenMP ̳߳ش֮ǰ
+    perfc::PerfCounters counters;
+    
     int N = atoi(argv[1]);
     int num_threads = atoi(argv[2]);
+    // --serial: ԴкPGO ѵͶԱã
+    bool run_serial = argc > 3 && strcmp(argv[3], "--serial") == 0;
     double h = 1.0 / (N + 1);
     int max_iter = 100;
     double tol = 1e-6;
@@ -85,6 +215,20 @@ int main(int argc, char* argv[]) {
     cout << "======================================================================" << endl;
     cout << "Grid Size: " << N << " x " << N << " x " << N << endl;
     cout << "Threads:   " << num_threads << endl;
+    
+    // ڴݶߣɨÿεÿ 8 flopɨдһ uһ f 48 ֽ
+    double dram_gbs = roofline::stream_triad_gbs(num_threads);
+    auto sweep_roofline = [&](int iters, double time_ms) {
+        double points = (double)N * N * N * iters;
+        return roofline::summary(8.0 * points, 48.0 * points, time_ms * 1e-3, dram_gbs);
+    };
+    // Ӧ飨check_schedule.hвƵĶÿε
+    auto print_checks = [](const CheckStats& st) {
+        cout << "  Checks: " << st.checks << ", wasted ~" << st.wasted << " iters, rate "
+             << fixed << setprecision(5) << st.rate << endl;
+    };
+    cout << "SIMD:      " << stencil_isa_name(stencil_isa()) << endl;
+    cout << "STREAM:    " << fixed << setprecision(1) << dram_gbs << " GB/s" << endl;
     cout << endl;
     
     // Initialize problem
@@ -100,11 +244,15 @@ int main(int argc, char* argv[]) {
         vector<double> u_test = u;
         int iter_count = 0;
         double residual = 0.0;
+        CheckStats stats;
         
+        counters.reset();
+        counters.start();
         auto start = high_resolution_clock::now();
         GaussSeidel3D::solve_parallel_redblack(u_test, f, N, h, max_iter, tol, 
-                                               iter_count, residual, num_threads);
+                                               iter_count, residual, num_threads, &stats);
         auto end = high_resolution_clock::now();
+        counters.stop();
         
         time_original = duration_cast<microseconds>(end - start).count() / 1e3;
         double error = compute_error(u_test, u_exact, N);
@@ -114,6 +262,62 @@ int main(int argc, char* argv[]) {
              << "| " << setw(10) << fixed << setprecision(2) << time_original
              << "| " << scientific << setprecision(2) << error
              << " | " << fixed << setprecision(2) << "1.00x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_original) << endl;
+        print_checks(stats);
+    }
+    
+    // Test red-black with the residual accumulated in the black sweep (convergence checked every iteration)
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        GaussSeidel3D::solve_parallel_redblack_fused(u_test, f, N, h, max_iter, tol, 
+                                           iter_count, residual, num_threads);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_fused = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_fused;
+        
+        cout << left << setw(18) << "Fused RB"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_fused
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_fused) << endl;
+    }
+    
+    // Test serial red-black ordering (optional)
+    if (run_serial) {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        GaussSeidel3D::solve_serial_redblack(u_test, f, N, h, max_iter, tol, 
+                                              iter_count, residual);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_serial = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_serial;
+        
+        cout << left << setw(18) << "Serial RB"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_serial
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
     }
     
     // Test 2-layer Tiling optimization
@@ -122,11 +326,15 @@ int main(int argc, char* argv[]) {
         vector<double> u_test = u;
         int iter_count = 0;
         double residual = 0.0;
+        CheckStats stats;
         
+        counters.reset();
+        counters.start();
         auto start = high_resolution_clock::now();
         GaussSeidel3DTiled::solve_4level_tiling(u_test, f, N, h, max_iter, tol, 
-                                                iter_count, residual, num_threads);
+                                                iter_count, residual, num_threads, &stats);
         auto end = high_resolution_clock::now();
+        counters.stop();
         
         time_tiled = duration_cast<microseconds>(end - start).count() / 1e3;
         double error = compute_error(u_test, u_exact, N);
@@ -137,6 +345,160 @@ int main(int argc, char* argv[]) {
              << "| " << setw(10) << fixed << setprecision(2) << time_tiled
              << "| " << scientific << setprecision(2) << error
              << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_tiled) << endl;
+        print_checks(stats);
+    }
+    
+    // Test temporal blocking (several red/black sweeps per cache-resident slab)
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        GaussSeidel3DTiled::solve_temporal_tiling(u_test, f, N, h, max_iter, tol, 
+                                  iter_count, residual, num_threads, 0, &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_temporal = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_temporal;
+        
+        cout << left << setw(18) << "Temporal"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_temporal
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_temporal) << endl;
+        print_checks(stats);
+    }
+    
+    // Test split red/black storage (unit-stride colour sweeps, conversion included in the time)
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        RedBlackSplit3D::solve(u_test, f, N, h, max_iter, tol, 
+                               iter_count, residual, num_threads, &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_split = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_split;
+        
+        cout << left << setw(18) << "Split RB"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_split
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_split) << endl;
+        print_checks(stats);
+    }
+    
+    // Test mixed precision: float red-black sweeps on the correction, double residual and refinement
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        MixedPrecisionGS3D::solve(u_test, f, N, h, max_iter, tol, 
+                   iter_count, residual, num_threads, &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_mixed = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_mixed;
+        
+        cout << left << setw(18) << "Mixed FP32"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_mixed
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        // float ɨÿ 24 ֽڣɨдһ eһ h^2 r
+        double points = (double)N * N * N * iter_count;
+        cout << "  " << roofline::summary(8.0 * points, 24.0 * points, time_mixed * 1e-3, dram_gbs) << endl;
+        print_checks(stats);
+    }
+    
+    // Test templated operator with a = 1 (vector row kernel)
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        UnitCoeff3D coeff(h, h, h);
+        Boundary3D bc;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        StencilGS3D<UnitCoeff3D>::solve(u_test, f, N, coeff, bc, max_iter, tol, 
+                                iter_count, residual, num_threads, &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_unit = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_unit;
+        
+        cout << left << setw(18) << "Stencil Unit"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_unit
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_unit) << endl;
+        print_checks(stats);
+    }
+    
+    // Test templated operator with a = 1 stored per point (variable-coefficient path)
+    {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        ArrayCoeff3D coeff(vector<double>((size_t)(N + 2) * (N + 2) * (N + 2), 1.0), N, h, h, h);
+        Boundary3D bc;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        StencilGS3D<ArrayCoeff3D>::solve(u_test, f, N, coeff, bc, max_iter, tol, 
+                                iter_count, residual, num_threads, &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_array = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_array;
+        
+        cout << left << setw(18) << "Stencil Array"
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_array
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_array) << endl;
+        print_checks(stats);
     }
     
     // Test Tiled + Memory Alignment optimization
@@ -144,11 +506,15 @@ int main(int argc, char* argv[]) {
         vector<double> u_test = u;
         int iter_count = 0;
         double residual = 0.0;
+        CheckStats stats;
         
+        counters.reset();
+        counters.start();
         auto start = high_resolution_clock::now();
         GaussSeidel3DTiledAligned::solve_4level_tiling_aligned(u_test, f, N, h, max_iter, tol, 
-                                                               iter_count, residual, num_threads);
+                                                               iter_count, residual, num_threads, &stats);
         auto end = high_resolution_clock::now();
+        counters.stop();
         
         double time_aligned = duration_cast<microseconds>(end - start).count() / 1e3;
         double error = compute_error(u_test, u_exact, N);
@@ -159,9 +525,135 @@ int main(int argc, char* argv[]) {
              << "| " << setw(10) << fixed << setprecision(2) << time_aligned
              << "| " << scientific << setprecision(2) << error
              << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        cout << "  " << sweep_roofline(iter_count, time_aligned) << endl;
+        print_checks(stats);
+    }
+    
+    // Test red-black SOR: optimal omega from h, and omega adapted from the residual history
+    const double omegas[] = { 0.0, -1.0 };
+    const char* sor_names[] = { "SOR RB", "SOR RB (auto)" };
+    for (int m = 0; m < 2; ++m) {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        CheckStats stats;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        GaussSeidel3D::solve_parallel_redblack_sor(u_test, f, N, h, max_iter, tol,
+                                                   iter_count, residual, num_threads, omegas[m], &stats);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_sor = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_sor;
+        
+        cout << left << setw(18) << sor_names[m]
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_sor
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+        print_checks(stats);
+    }
+    
+    // Test matrix-free PCG (plain CG and red-black SGS preconditioner)
+    const PCGPreconditioner preconds[] = { PCG_NONE, PCG_SGS };
+    const char* pcg_names[] = { "CG", "PCG-SGS" };
+    for (int m = 0; m < 2; ++m) {
+        vector<double> u_test = u;
+        int iter_count = 0;
+        double residual = 0.0;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        PCG3D::solve(u_test, f, N, h, preconds[m], max_iter, tol,
+                     iter_count, residual, num_threads);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_pcg = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_pcg;
+        
+        cout << left << setw(18) << pcg_names[m]
+             << "| " << setw(9) << iter_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_pcg
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
+    }
+    
+    // Test geometric multigrid (red-black smoother); Iters column = cycles
+    const MGCycle cycles[] = { MG_V_CYCLE, MG_W_CYCLE, MG_FMG };
+    for (int c = 0; c < 3; ++c) {
+        vector<double> u_test = u;
+        int cycle_count = 0;
+        double residual = 0.0;
+        
+        counters.reset();
+        counters.start();
+        auto start = high_resolution_clock::now();
+        Multigrid3D::solve(u_test, f, N, h, cycles[c], 50, tol,
+                            cycle_count, residual, num_threads);
+        auto end = high_resolution_clock::now();
+        counters.stop();
+        
+        double time_mg = duration_cast<microseconds>(end - start).count() / 1e3;
+        double error = compute_error(u_test, u_exact, N);
+        double speedup = time_original / time_mg;
+        string name = string("Multigrid ") + mg_cycle_name(cycles[c]);
+        
+        cout << left << setw(18) << name
+             << "| " << setw(9) << cycle_count
+             << "| " << setw(10) << fixed << setprecision(2) << time_mg
+             << "| " << scientific << setprecision(2) << error
+             << " | " << fixed << setprecision(2) << speedup << "x" << endl;
+        cout << "  " << counters.summary(1) << endl;
     }
     
     cout << "======================================================================" << endl;
     
-    return 0;
+    // ϵԼ Neumann 飺һ½
+    // ȫ Dirichlet ΪףNeumann һײʹ彵Ϊһףʱط
+    bool mms_ok = true;
+    cout << "Manufactured solution (a = 1 + x + y^2 + z, hz = 2hx)" << endl;
+    for (int nm = 0; nm < 2; ++nm) {
+        const bool neumann = nm == 1;
+        const double min_order = neumann ? 0.8 : 1.8;
+        double prev = 0.0;
+        for (int n = 15; n <= 31; n = 2 * n + 1) {
+            int iters = 0;
+            double err = manufactured_error_3d(n, neumann, num_threads, iters);
+            cout << "  " << (neumann ? "Neumann z=0" : "Dirichlet  ") << "  N = " << setw(3) << n
+                 << "  iters " << setw(6) << iters << "  max error " << scientific << setprecision(2) << err;
+            if (prev > 0.0) {
+                double order = log(prev / err) / log(2.0);
+                bool ok = order >= min_order;
+                cout << "  order " << fixed << setprecision(2) << order << (ok ? "" : "  FAIL");
+                mms_ok = mms_ok && ok;
+            }
+            cout << endl;
+            prev = err;
+        }
+    }
+    
+    // Ҷ±ȽӦ  밴 h  أ 20% ʱط
+    bool sor_ok = true;
+    cout << "SOR auto omega, random RHS (N = 31, tol = 1e-6 r0)" << endl;
+    for (int p = 0; p < 2; ++p) {
+        const bool parallel = p == 0;
+        int iters_h = sor_random_rhs_iterations(31, 0.0, parallel, num_threads);
+        int iters_auto = sor_random_rhs_iterations(31, -1.0, parallel, num_threads);
+        bool ok = iters_auto <= 1.2 * iters_h;
+        cout << "  " << (parallel ? "red-black" : "serial   ") << "  iters h-optimal " << setw(6) << iters_h
+             << "  auto " << setw(6) << iters_auto << (ok ? "" : "  FAIL") << endl;
+        sor_ok = sor_ok && ok;
+    }
+    
+    return (mms_ok && sor_ok) ? 0 : 1;
 }
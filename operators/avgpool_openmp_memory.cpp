@@ -1,13 +1,12 @@
-#include <cmath>
-#include <fstream>
 #include <iostream>
 #include <vector>
-#include <chrono>
-#include <time.h> 
-#include <random>
 #include <cstring>
 #include <algorithm>
 #include <omp.h>
+#include "ops.h"
+#include "loadgen.h"
+#include "../common/perf_counters.h"
+#include "../common/affinity.h"
 
 #if defined(_WIN32)
 #define PATH_SEPARATOR "\\\\"
@@ -16,207 +15,9 @@
 #include <malloc.h>
 #endif
 
-struct Mat
-{
-public:
-    std::vector<float> tensor;
-
-    int dim;
-    int channel;
-    int height;
-    int width;
-
-    Mat() : dim(1), channel(3), height(150), width(150) {
-        tensor.resize(dim * channel * height * width);
-    }
-
-    // 多态构造函数
-    Mat(int d, int c, int h, int w) : dim(d), channel(c), height(h), width(w) {
-        tensor.resize(d * c * h * w);
-    }
-
-    float& operator[](size_t index)
-    {
-        return tensor[index];
-    }
-
-    const float& operator[](size_t index) const
-    {
-        return tensor[index];
-    }
-};
-
-std::vector<int> padding;
-std::vector<int> kernel_size;
-std::vector<int> stride;
-std::vector<int> dilation;
-
-double get_current_time()
-{
-    auto now = std::chrono::high_resolution_clock::now();
-    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
-    return usec.count() / 1000.0;
-}
-
-void pretensor(Mat& input)
-{
-    for (int i = 0; i < input.channel; ++i)
-    {
-        for (int j = 0; j < input.height; ++j)
-        {
-            for (int k = 0; k < input.width; ++k)
-            {
-                int index = i * input.height * input.width + j * input.width + k;
-                float value = std::sin(static_cast<float>(index));
-                input[index] = value;
-            }
-        }
-    }
-}
-
-void printMat(Mat& mat)
-{
-    for (int d = 0; d < mat.dim; ++d)
-    {
-        for (int c = 0; c < mat.channel; ++c)
-        {
-            for (int h = 0; h < mat.height; ++h)
-            {
-                for (int w = 0; w < mat.width; ++w)
-                {
-                    int index = d * mat.channel * mat.height * mat.width + c * mat.height * mat.width + h * mat.width + w;
-                    printf("%.5lf ", mat[index]);
-                }
-                std::puts("");
-            }
-            std::puts("");
-        }
-
-        std::puts("");
-    }
-    std::puts("");
-}
-
-// Optimized avgpool with memory and access pattern optimization
-double avgp(const Mat &input, Mat &output, std::vector<int> avgp_kernel_size, std::vector<int> avgp_stride)
-{
-    double start = get_current_time();
-    int input_h = input.height;
-    int input_w = input.width;
-    int out_h = output.height;
-    int out_w = output.width;
-    
-    int kernel_h = avgp_kernel_size[0];
-    int kernel_w = avgp_kernel_size[1];
-    int stride_h = avgp_stride[1];
-    int stride_w = avgp_stride[0];
-    
-    // Precompute sizes
-    int input_hw = input_h * input_w;
-    int output_hw = out_h * out_w;
-    
-    // Check if we can use specialized 2x2 kernel optimization
-    bool use_2x2_optimized = (kernel_h == 2 && kernel_w == 2 && 
-                               stride_h == 2 && stride_w == 2);
-    
-    for (int d = 0; d < input.dim; ++d)
-    {
-        // Parallelize over channels - optimal granularity
-        #pragma omp parallel for
-        for (int c = 0; c < input.channel; ++c)
-        {
-            // Precompute channel offsets using pointers
-            const float* input_channel_ptr = &input.tensor[d * input.channel * input_hw + c * input_hw];
-            float* output_channel_ptr = &output.tensor[d * output.channel * output_hw + c * output_hw];
-            
-            if (use_2x2_optimized)
-            {
-                // Specialized optimization for 2x2 kernel with stride 2
-                // Unroll kernel loops for better performance
-                for (int oh = 0; oh < out_h; ++oh)
-                {
-                    for (int ow = 0; ow < out_w; ++ow)
-                    {
-                        // Input coordinates
-                        int h_start = oh * 2;
-                        int w_start = ow * 2;
-                        
-                        // Check if all 4 pixels are within bounds
-                        if (h_start + 1 < input_h && w_start + 1 < input_w)
-                        {
-                            // Direct access to 4 pixels in 2x2 kernel
-                            int idx_00 = h_start * input_w + w_start;
-                            int idx_01 = idx_00 + 1;
-                            int idx_10 = idx_00 + input_w;
-                            int idx_11 = idx_10 + 1;
-                            
-                            // Compute average of 4 pixels
-                            float sum = input_channel_ptr[idx_00] + 
-                                       input_channel_ptr[idx_01] + 
-                                       input_channel_ptr[idx_10] + 
-                                       input_channel_ptr[idx_11];
-                            
-                            output_channel_ptr[oh * out_w + ow] = sum * 0.25f; // Multiply instead of divide
-                        }
-                        else
-                        {
-                            // Boundary case - use general approach
-                            float sum = 0.0f;
-                            int count = 0;
-                            for (int kh = 0; kh < 2; ++kh)
-                            {
-                                for (int kw = 0; kw < 2; ++kw)
-                                {
-                                    int h = h_start + kh;
-                                    int w = w_start + kw;
-                                    if (h < input_h && w < input_w)
-                                    {
-                                        sum += input_channel_ptr[h * input_w + w];
-                                        count++;
-                                    }
-                                }
-                            }
-                            output_channel_ptr[oh * out_w + ow] = sum / count;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                // General case for arbitrary kernel sizes
-                for (int oh = 0; oh < out_h; ++oh)
-                {
-                    for (int ow = 0; ow < out_w; ++ow)
-                    {
-                        float sum = 0.0f;
-                        int count = 0;
-                        
-                        int h_start = oh * stride_h;
-                        int w_start = ow * stride_w;
-                        
-                        for (int kh = 0; kh < kernel_h; ++kh)
-                        {
-                            for (int kw = 0; kw < kernel_w; ++kw)
-                            {
-                                int h = h_start + kh;
-                                int w = w_start + kw;
-                                if (h < input_h && w < input_w)
-                                {
-                                    sum += input_channel_ptr[h * input_w + w];
-                                    count++;
-                                }
-                            }
-                        }
-                        output_channel_ptr[oh * out_w + ow] = sum / count;
-                    }
-                }
-            }
-        }
-    }
-    double end = get_current_time();
-    return (end - start);
-}
-
+// pool1 layer: 320x300x300 -> 320x150x150, 2x2 kernel, stride 2
+const int CHANNELS = 320, IN_H = 300, IN_W = 300;
+const int KERNEL = 2, STRIDE = 2;
 
 int main(int argc, char* argv[])
 {
@@ -229,11 +30,41 @@ int main(int argc, char* argv[])
     // std::cout << "Memory optimization: Skipped (mallopt not available on this platform)" << std::endl;
     #endif
     
-    // Get thread count from command line argument
+    // Get thread count from command line argument;
+    // --qps <list|auto> [--requests N] switches to an open-loop load test;
+    // --bind none|compact|spread pins the worker threads from the program itself,
+    // --mem first-touch|interleave|node<N> selects the NUMA placement of the tensors
     int num_threads = omp_get_max_threads();
-    if (argc > 1)
+    std::string qps_spec;
+    int num_requests = 200;
+    affinity::Binding binding = affinity::BIND_NONE;
+    numa::Policy mem_policy = numa::POLICY_FIRST_TOUCH;
+    int mem_node = 0;
+    for (int a = 1; a < argc; ++a)
     {
-        num_threads = std::atoi(argv[1]);
+        if (std::strcmp(argv[a], "--bind") == 0 && a + 1 < argc)
+        {
+            if (!affinity::parse_binding(argv[++a], binding))
+                std::cerr << "Unknown --bind policy, using none" << std::endl;
+            continue;
+        }
+        if (std::strcmp(argv[a], "--mem") == 0 && a + 1 < argc)
+        {
+            if (!numa::parse_policy(argv[++a], mem_policy, mem_node))
+                std::cerr << "Unknown --mem policy, using first-touch" << std::endl;
+            continue;
+        }
+        if (std::strcmp(argv[a], "--qps") == 0 && a + 1 < argc)
+        {
+            qps_spec = argv[++a];
+            continue;
+        }
+        if (std::strcmp(argv[a], "--requests") == 0 && a + 1 < argc)
+        {
+            num_requests = std::max(1, std::atoi(argv[++a]));
+            continue;
+        }
+        num_threads = std::atoi(argv[a]);
         if (num_threads <= 0)
         {
             std::cerr << "Invalid thread count. Using default: " << omp_get_max_threads() << std::endl;
@@ -241,27 +72,72 @@ int main(int argc, char* argv[])
         }
     }
     omp_set_num_threads(num_threads);
-    std::cout << "Using " << num_threads << " threads (Memory Optimized)" << std::endl;
     
-    padding.assign(0, 0);     
-    kernel_size.assign(2, 2); 
-    stride.assign(2, 2);      
-
-    Mat mp1_input(1, 320, 300, 300);
-    Mat mp1_output(1, 320, 150, 150);
+    // Open hardware counters before the OpenMP thread pool is created
+    perfc::PerfCounters counters;
+    std::cout << "Using " << num_threads << " threads (Memory Optimized)" << std::endl;
 
-    pretensor(mp1_input);
+    // Pin the team before anything is first-touched, so the pages placed by
+    // first_touch() stay local to the threads that later compute on them
+    if (binding != affinity::BIND_NONE && !affinity::pin_omp_team(affinity::plan_cpus(num_threads, binding)))
+        std::cerr << "Thread pinning failed" << std::endl;
+    std::cout << "Binding: " << affinity::binding_name(binding)
+              << ", memory: " << numa::policy_name(mem_policy) << std::endl;
+    
+    // One-time work (task decomposition, NUMA first-touch) happens before the
+    // timed request path
+    ops::AvgPool2d pool1(KERNEL, STRIDE);
+    pool1.set_name("pool1");
+    pool1.prepare(1, CHANNELS, IN_H, IN_W, num_threads);
+
+    ops::Tensor mp1_input(1, CHANNELS, IN_H, IN_W);
+    ops::Tensor mp1_output(1, CHANNELS, pool1.out_h(), pool1.out_w());
+    ops::TensorView input_view = mp1_input.view();
+    ops::TensorView output_view = mp1_output.view();
+
+    if (mem_policy != numa::POLICY_FIRST_TOUCH)
+    {
+        mp1_input.place(mem_policy, mem_node);
+        mp1_output.place(mem_policy, mem_node);
+    }
+    pool1.first_touch(input_view, output_view);
+    ops::fill_sin(input_view);
+
+    auto avgp = [&]() -> double {
+        double start = ops::now_ms();
+        pool1.execute(input_view, output_view);
+        return ops::now_ms() - start;
+    };
     
     // Run 250 iterations: 50 warmup + 200 for statistics
     const int total_iterations = 250;
     const int warmup_iterations = 50;
     double times[total_iterations];
     
+    // Open-loop mode: Poisson arrivals drive avgp, latency includes queueing
+    if (!qps_spec.empty())
+    {
+        for (int i = 0; i < warmup_iterations; ++i)
+        {
+            times[i] = avgp();
+        }
+        std::sort(times, times + warmup_iterations);
+        double service_ms = times[warmup_iterations / 2];
+        std::vector<double> qps_list = loadgen::parse_qps_list(qps_spec, service_ms);
+        std::cout << "Open-loop load test: service time " << service_ms << " ms, "
+                  << num_requests << " requests per point" << std::endl;
+        loadgen::sweep([&]() {
+            avgp();
+        }, qps_list, num_requests, "avgpool_latency_curve.csv");
+        prof::Profiler::instance().dump();
+        return 0;
+    }
+    
     for (int i = 0; i < total_iterations; ++i)
     {
-        // Reset output matrix
-        std::fill(mp1_output.tensor.begin(), mp1_output.tensor.end(), 0);
-        times[i] = avgp(mp1_input, mp1_output, kernel_size, stride);
+        if (i >= warmup_iterations) counters.start();
+        times[i] = avgp();
+        if (i >= warmup_iterations) counters.stop();
     }
     
     // Extract and sort times after warmup
@@ -292,6 +168,8 @@ int main(int argc, char* argv[])
     
     std::cout << "Median time (after warmup): " << median << " ms" << std::endl;
     std::cout << "P99 time (after warmup): " << p99 << " ms" << std::endl;
+    counters.print_summary(std::cout, valid_count);
+    prof::Profiler::instance().dump();
 
     return 0;
 }
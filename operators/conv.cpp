@@ -15,6 +15,11 @@
 #define PATH_SEPARATOR "/"
 #endif
 
+// 权重目录，CMake 构建时定义为源码树中的 operators/src 的绝对路径
+#ifndef OPERATORS_WEIGHT_DIR
+#define OPERATORS_WEIGHT_DIR "src"
+#endif
+
 #include <vector>
 
 struct Mat
@@ -244,8 +249,8 @@ int main()
     //omp_set_num_threads(2);
     std::vector<float> conv2_weight(32 * 3 * 5 * 5);
     std::vector<float> conv2_bias(32);
-    std::string conv2_weight_path = ".\\src" PATH_SEPARATOR "conv1.weight.bin";
-    std::string conv2_bias_path = ".\\src" PATH_SEPARATOR "conv1.bias.bin";
+    std::string conv2_weight_path = OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.weight.bin";
+    std::string conv2_bias_path = OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.bias.bin";
     readBinaryFile(conv2_weight_path, conv2_weight);
     readBinaryFile(conv2_bias_path, conv2_bias);
     pretensor(conv2_input);
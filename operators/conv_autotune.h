@@ -0,0 +1,470 @@
+#ifndef OPERATORS_CONV_AUTOTUNE_H
+#define OPERATORS_CONV_AUTOTUNE_H
+
+// 卷积自动调优：在目标机器上针对每个层形状搜索循环顺序、分块大小和线程数，
+// 最优配置写入调优缓存文件，之后的运行在启动时读取。
+//
+// 两种循环顺序：
+//   LOOP_SPATIAL  按 (oh, ow) 分块并行，每个输出点计算所有输出通道（原 collapse(2) 方案）
+//   LOOP_CHANNEL  按 (oc, oh) 分块并行，最内层沿 ow 连续累加，便于向量化和权重复用
+//
+// 输出较大时两种循环顺序都改用非临时写（见 stream_store.h），调优测得的时间已包含这一点。
+//
+// 缓存文件默认 conv_tuning.cache，可用环境变量 CONV_TUNE_CACHE 指定。
+// 每行：<形状键> <循环顺序> <tile_oc> <tile_oh> <tile_ow> <线程数> <中位数时间ms>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "stream_store.h"
+
+namespace convtune {
+
+enum LoopOrder
+{
+    LOOP_SPATIAL = 0,
+    LOOP_CHANNEL = 1,
+    NUM_LOOP_ORDERS
+};
+
+inline const char* loop_order_name(int order)
+{
+    return order == LOOP_CHANNEL ? "channel" : "spatial";
+}
+
+// 卷积层形状（输入为已经 padding 之后的尺寸）
+struct ConvShape
+{
+    int c_in;
+    int in_h;
+    int in_w;
+    int c_out;
+    int k_h;
+    int k_w;
+    int stride_h;
+    int stride_w;
+    int out_h;
+    int out_w;
+    // 行 / 通道步长（元素数），0 表示连续存放（行步长 = 宽度，通道步长 = 高 x 宽），
+    // 输入输出可以是更大张量中的带步长视图
+    int in_row_stride;
+    int in_plane_stride;
+    int out_row_stride;
+    int out_plane_stride;
+
+    ConvShape()
+        : c_in(0), in_h(0), in_w(0), c_out(0), k_h(0), k_w(0), stride_h(1), stride_w(1), out_h(0), out_w(0),
+          in_row_stride(0), in_plane_stride(0), out_row_stride(0), out_plane_stride(0) {}
+
+    int in_ld() const { return in_row_stride > 0 ? in_row_stride : in_w; }
+    int in_plane() const { return in_plane_stride > 0 ? in_plane_stride : in_h * in_w; }
+    int out_ld() const { return out_row_stride > 0 ? out_row_stride : out_w; }
+    int out_plane() const { return out_plane_stride > 0 ? out_plane_stride : out_h * out_w; }
+
+    // 步长不影响最优配置，不计入键
+    std::string key() const
+    {
+        std::ostringstream os;
+        os << "c" << c_in << "x" << in_h << "x" << in_w << "_o" << c_out
+           << "_k" << k_h << "x" << k_w << "_s" << stride_h << "x" << stride_w;
+        return os.str();
+    }
+};
+
+struct ConvConfig
+{
+    int loop_order;
+    int tile_oc;
+    int tile_oh;
+    int tile_ow;
+    int num_threads;
+};
+
+// 与原实现一致：逐输出点 collapse(2) 并行
+inline ConvConfig default_config(int num_threads)
+{
+    ConvConfig cfg;
+    cfg.loop_order = LOOP_SPATIAL;
+    cfg.tile_oc = 0;
+    cfg.tile_oh = 1;
+    cfg.tile_ow = 1;
+    cfg.num_threads = num_threads;
+    return cfg;
+}
+
+inline std::string config_string(const ConvConfig& cfg)
+{
+    std::ostringstream os;
+    os << loop_order_name(cfg.loop_order) << " tile_oc=" << cfg.tile_oc << " tile_oh=" << cfg.tile_oh
+       << " tile_ow=" << cfg.tile_ow << " threads=" << cfg.num_threads;
+    return os.str();
+}
+
+// 单个输出点的所有输入通道累加；KH/KW 为编译期常量时内层完全展开
+template <int KH, int KW>
+inline float conv_point(const float* input, const float* weight, int c_in, int in_hw, int in_w)
+{
+    float sum = 0.0f;
+    for (int ic = 0; ic < c_in; ++ic)
+    {
+        const float* input_ptr = input + ic * in_hw;
+        const float* weight_ptr = weight + ic * KH * KW;
+        #pragma GCC unroll 8
+        for (int kh = 0; kh < KH; ++kh)
+        {
+            #pragma GCC unroll 8
+            for (int kw = 0; kw < KW; ++kw)
+            {
+                sum += weight_ptr[kh * KW + kw] * input_ptr[kh * in_w + kw];
+            }
+        }
+    }
+    return sum;
+}
+
+inline float conv_point_generic(const float* input, const float* weight, int c_in, int in_hw, int in_w,
+                                int k_h, int k_w)
+{
+    float sum = 0.0f;
+    for (int ic = 0; ic < c_in; ++ic)
+    {
+        const float* input_ptr = input + ic * in_hw;
+        const float* weight_ptr = weight + ic * k_h * k_w;
+        for (int kh = 0; kh < k_h; ++kh)
+        {
+            for (int kw = 0; kw < k_w; ++kw)
+            {
+                sum += weight_ptr[kh * k_w + kw] * input_ptr[kh * in_w + kw];
+            }
+        }
+    }
+    return sum;
+}
+
+// 输出总量足够大、且一行块宽度凑得满整条缓存行时，内核先在栈上缓冲一行结果再非临时写出
+inline bool conv2d_streams(const ConvShape& s, int row_floats)
+{
+    return row_floats >= 16 && row_floats <= nt::ROW_BUFFER &&
+           nt::use_for((size_t)s.c_out * s.out_h * s.out_w * sizeof(float));
+}
+
+// 空间分块：每个 (tile_oh x tile_ow) 块内逐点计算全部输出通道
+inline void conv2d_spatial(const ConvShape& s, const float* input, const float* weight, const float* bias,
+                           float* output, const ConvConfig& cfg)
+{
+    const int in_hw = s.in_plane();
+    const int in_ld = s.in_ld();
+    const int out_hw = s.out_plane();
+    const int out_ld = s.out_ld();
+    const int kernel_max = s.k_h * s.k_w;
+    const int tile_oh = std::max(1, cfg.tile_oh);
+    const int tile_ow = std::max(1, cfg.tile_ow);
+    // 缓冲区按 [oc][ow] 存放一行块的全部输出通道
+    const bool stream = std::min(tile_ow, s.out_w) >= 16 && conv2d_streams(s, s.c_out * tile_ow);
+
+    #pragma omp parallel num_threads(cfg.num_threads)
+    {
+        alignas(64) float buf[nt::ROW_BUFFER];
+
+        #pragma omp for collapse(2) schedule(static) nowait
+        for (int bh = 0; bh < s.out_h; bh += tile_oh) {
+            for (int bw = 0; bw < s.out_w; bw += tile_ow) {
+                int h_end = std::min(bh + tile_oh, s.out_h);
+                int w_end = std::min(bw + tile_ow, s.out_w);
+                for (int oh = bh; oh < h_end; ++oh) {
+                    for (int ow = bw; ow < w_end; ++ow) {
+                        const float* input_ptr = input + oh * s.stride_h * in_ld + ow * s.stride_w;
+                        for (int oc = 0; oc < s.c_out; ++oc) {
+                            const float* weight_ptr = weight + oc * s.c_in * kernel_max;
+                            float sum;
+                            if (s.k_h == 5 && s.k_w == 5)
+                                sum = conv_point<5, 5>(input_ptr, weight_ptr, s.c_in, in_hw, in_ld);
+                            else if (s.k_h == 3 && s.k_w == 3)
+                                sum = conv_point<3, 3>(input_ptr, weight_ptr, s.c_in, in_hw, in_ld);
+                            else
+                                sum = conv_point_generic(input_ptr, weight_ptr, s.c_in, in_hw, in_ld, s.k_h, s.k_w);
+                            if (stream)
+                                buf[oc * tile_ow + (ow - bw)] = sum + bias[oc];
+                            else
+                                output[oc * out_hw + oh * out_ld + ow] = sum + bias[oc];
+                        }
+                    }
+                    if (stream) {
+                        for (int oc = 0; oc < s.c_out; ++oc)
+                            nt::store_row(output + oc * out_hw + oh * out_ld + bw, buf + oc * tile_ow, w_end - bw);
+                    }
+                }
+            }
+        }
+        if (stream)
+            nt::fence();
+    }
+}
+
+// 通道分块：每个 (tile_oc x tile_oh) 块按行累加，ow 为最内层连续循环
+inline void conv2d_channel(const ConvShape& s, const float* input, const float* weight, const float* bias,
+                           float* output, const ConvConfig& cfg)
+{
+    const int in_hw = s.in_plane();
+    const int in_ld = s.in_ld();
+    const int out_hw = s.out_plane();
+    const int out_ld = s.out_ld();
+    const int kernel_max = s.k_h * s.k_w;
+    const int tile_oc = std::max(1, cfg.tile_oc);
+    const int tile_oh = std::max(1, cfg.tile_oh);
+    const int tile_ow = std::max(1, cfg.tile_ow);
+    const bool stream = conv2d_streams(s, std::min(tile_ow, s.out_w));
+
+    #pragma omp parallel num_threads(cfg.num_threads)
+    {
+        alignas(64) float buf[nt::ROW_BUFFER];
+
+        #pragma omp for collapse(2) schedule(static) nowait
+        for (int bc = 0; bc < s.c_out; bc += tile_oc) {
+            for (int bh = 0; bh < s.out_h; bh += tile_oh) {
+                int c_end = std::min(bc + tile_oc, s.c_out);
+                int h_end = std::min(bh + tile_oh, s.out_h);
+                for (int bw = 0; bw < s.out_w; bw += tile_ow) {
+                    int w_end = std::min(bw + tile_ow, s.out_w);
+                    for (int oc = bc; oc < c_end; ++oc) {
+                        for (int oh = bh; oh < h_end; ++oh) {
+                            // 累加目标：直接写输出行，或者先在缓冲区累加、最后整行非临时写出
+                            float* out_row = output + oc * out_hw + oh * out_ld;
+                            float* acc = stream ? buf : out_row + bw;
+                            for (int ow = bw; ow < w_end; ++ow)
+                                acc[ow - bw] = bias[oc];
+                            for (int ic = 0; ic < s.c_in; ++ic) {
+                                const float* weight_ptr = weight + (oc * s.c_in + ic) * kernel_max;
+                                for (int kh = 0; kh < s.k_h; ++kh) {
+                                    const float* in_row = input + ic * in_hw + (oh * s.stride_h + kh) * in_ld;
+                                    for (int kw = 0; kw < s.k_w; ++kw) {
+                                        const float wv = weight_ptr[kh * s.k_w + kw];
+                                        const float* in_ptr = in_row + kw;
+                                        if (s.stride_w == 1) {
+                                            #pragma omp simd
+                                            for (int ow = bw; ow < w_end; ++ow)
+                                                acc[ow - bw] += wv * in_ptr[ow];
+                                        } else {
+                                            for (int ow = bw; ow < w_end; ++ow)
+                                                acc[ow - bw] += wv * in_ptr[ow * s.stride_w];
+                                        }
+                                    }
+                                }
+                            }
+                            if (stream)
+                                nt::store_row(out_row + bw, buf, w_end - bw);
+                        }
+                    }
+                }
+            }
+        }
+        if (stream)
+            nt::fence();
+    }
+}
+
+inline void conv2d_run(const ConvShape& s, const float* input, const float* weight, const float* bias,
+                       float* output, const ConvConfig& cfg)
+{
+    if (cfg.loop_order == LOOP_CHANNEL)
+        conv2d_channel(s, input, weight, bias, output, cfg);
+    else
+        conv2d_spatial(s, input, weight, bias, output, cfg);
+}
+
+// 调优缓存：形状键 -> 最优配置
+class TuningCache
+{
+public:
+    struct Entry
+    {
+        ConvConfig config;
+        double time_ms;
+    };
+
+    TuningCache()
+    {
+        const char* env = std::getenv("CONV_TUNE_CACHE");
+        path_ = (env && env[0] != '\0') ? env : "conv_tuning.cache";
+    }
+
+    explicit TuningCache(const std::string& path) : path_(path) {}
+
+    const std::string& path() const { return path_; }
+
+    // 文件不存在视为空缓存
+    bool load()
+    {
+        std::ifstream in(path_.c_str());
+        if (!in.is_open())
+            return false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream is(line);
+            std::string key;
+            Entry e;
+            if (is >> key >> e.config.loop_order >> e.config.tile_oc >> e.config.tile_oh
+                   >> e.config.tile_ow >> e.config.num_threads >> e.time_ms)
+            {
+                entries_[key] = e;
+            }
+        }
+        return true;
+    }
+
+    bool save() const
+    {
+        std::ofstream out(path_.c_str());
+        if (!out.is_open())
+        {
+            std::cerr << "Failed to write tuning cache: " << path_ << std::endl;
+            return false;
+        }
+        out << "# key loop_order tile_oc tile_oh tile_ow num_threads time_ms\n";
+        for (std::map<std::string, Entry>::const_iterator it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            const ConvConfig& c = it->second.config;
+            out << it->first << " " << c.loop_order << " " << c.tile_oc << " " << c.tile_oh << " "
+                << c.tile_ow << " " << c.num_threads << " " << it->second.time_ms << "\n";
+        }
+        return true;
+    }
+
+    bool lookup(const ConvShape& shape, ConvConfig& config) const
+    {
+        std::map<std::string, Entry>::const_iterator it = entries_.find(shape.key());
+        if (it == entries_.end())
+            return false;
+        config = it->second.config;
+        return true;
+    }
+
+    void put(const ConvShape& shape, const ConvConfig& config, double time_ms)
+    {
+        Entry e;
+        e.config = config;
+        e.time_ms = time_ms;
+        entries_[shape.key()] = e;
+    }
+
+private:
+    std::string path_;
+    std::map<std::string, Entry> entries_;
+};
+
+// 单个配置的中位数耗时（ms）
+inline double time_config(const ConvShape& s, const float* input, const float* weight, const float* bias,
+                          float* output, const ConvConfig& cfg, int repeats)
+{
+    conv2d_run(s, input, weight, bias, output, cfg);  // 预热
+    std::vector<double> times(repeats);
+    for (int r = 0; r < repeats; ++r)
+    {
+        double t0 = omp_get_wtime();
+        conv2d_run(s, input, weight, bias, output, cfg);
+        times[r] = (omp_get_wtime() - t0) * 1000.0;
+    }
+    std::sort(times.begin(), times.end());
+    return times[repeats / 2];
+}
+
+inline void push_unique(std::vector<int>& v, int x)
+{
+    if (x > 0 && std::find(v.begin(), v.end(), x) == v.end())
+        v.push_back(x);
+}
+
+// 两阶段搜索：先在最大线程数下搜索循环顺序和分块，再为最优分块搜索线程数
+inline ConvConfig autotune(const ConvShape& s, const float* input, const float* weight, const float* bias,
+                           float* output, int max_threads, double& best_time_ms, int repeats = 5,
+                           bool verbose = true)
+{
+    std::vector<ConvConfig> candidates;
+
+    std::vector<int> sp_oh, sp_ow;
+    push_unique(sp_oh, 1); push_unique(sp_oh, 2); push_unique(sp_oh, 4); push_unique(sp_oh, 8);
+    push_unique(sp_ow, 1); push_unique(sp_ow, std::min(8, s.out_w));
+    push_unique(sp_ow, std::min(32, s.out_w)); push_unique(sp_ow, s.out_w);
+    for (size_t i = 0; i < sp_oh.size(); ++i)
+    {
+        for (size_t j = 0; j < sp_ow.size(); ++j)
+        {
+            ConvConfig c = default_config(max_threads);
+            c.tile_oh = sp_oh[i];
+            c.tile_ow = sp_ow[j];
+            candidates.push_back(c);
+        }
+    }
+
+    std::vector<int> ch_oc, ch_oh, ch_ow;
+    push_unique(ch_oc, 1); push_unique(ch_oc, std::min(4, s.c_out));
+    push_unique(ch_oc, std::min(8, s.c_out)); push_unique(ch_oc, std::min(16, s.c_out));
+    push_unique(ch_oh, 1); push_unique(ch_oh, std::min(4, s.out_h)); push_unique(ch_oh, std::min(16, s.out_h));
+    push_unique(ch_ow, std::min(32, s.out_w)); push_unique(ch_ow, std::min(64, s.out_w)); push_unique(ch_ow, s.out_w);
+    for (size_t i = 0; i < ch_oc.size(); ++i)
+    {
+        for (size_t j = 0; j < ch_oh.size(); ++j)
+        {
+            for (size_t k = 0; k < ch_ow.size(); ++k)
+            {
+                ConvConfig c;
+                c.loop_order = LOOP_CHANNEL;
+                c.tile_oc = ch_oc[i];
+                c.tile_oh = ch_oh[j];
+                c.tile_ow = ch_ow[k];
+                c.num_threads = max_threads;
+                candidates.push_back(c);
+            }
+        }
+    }
+
+    ConvConfig best = candidates[0];
+    best_time_ms = 1e300;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        double t = time_config(s, input, weight, bias, output, candidates[i], repeats);
+        if (verbose)
+            std::cout << "  [tune] " << config_string(candidates[i]) << " : " << t << " ms" << std::endl;
+        if (t < best_time_ms)
+        {
+            best_time_ms = t;
+            best = candidates[i];
+        }
+    }
+
+    std::vector<int> threads;
+    const int thread_steps[] = { 1, 2, 4, 8, 10, 16, 20, 32, 64 };
+    for (size_t i = 0; i < sizeof(thread_steps) / sizeof(thread_steps[0]); ++i)
+    {
+        if (thread_steps[i] < max_threads)
+            push_unique(threads, thread_steps[i]);
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        ConvConfig c = best;
+        c.num_threads = threads[i];
+        double t = time_config(s, input, weight, bias, output, c, repeats);
+        if (verbose)
+            std::cout << "  [tune] " << config_string(c) << " : " << t << " ms" << std::endl;
+        if (t < best_time_ms)
+        {
+            best_time_ms = t;
+            best = c;
+        }
+    }
+    return best;
+}
+
+} // namespace convtune
+
+#endif // OPERATORS_CONV_AUTOTUNE_H
@@ -1,13 +1,12 @@
-#include <cmath>
-#include <fstream>
 #include <iostream>
 #include <vector>
-#include <chrono>
-#include <time.h> 
-#include <random>
 #include <cstring>
 #include <algorithm>
 #include <omp.h>
+#include "ops.h"
+#include "loadgen.h"
+#include "../common/perf_counters.h"
+#include "../common/affinity.h"
 
 #if defined(_WIN32)
 #define PATH_SEPARATOR "\\\\"
@@ -15,243 +14,59 @@
 #define PATH_SEPARATOR "/"
 #endif
 
-#include <vector>
-
-struct Mat
-{
-public:
-    std::vector<float> tensor;
-
-    int dim;
-    int channel;
-    int height;
-    int width;
-
-    Mat() : dim(1), channel(3), height(150), width(150) {
-        tensor.resize(dim * channel * height * width);
-    }
-
-    // ̬캯
-    Mat(int d, int c, int h, int w) : dim(d), channel(c), height(h), width(w) {
-        tensor.resize(d * c * h * w);
-    }
-
-    float& operator[](size_t index)
-    {
-        return tensor[index];
-    }
-
-    const float& operator[](size_t index) const
-    {
-        return tensor[index];
-    }
-};
-
-
-
-bool readBinaryFile(const std::string& filepath, std::vector<float>& buffer)
-{
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open())
-    {
-        std::cerr << "Failed to open file: " << filepath << std::endl;
-        return false;
-    }
-
-    file.seekg(0, std::ios::end);
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    size_t numFloats = size / sizeof(float);
-    buffer.resize(numFloats);
-    if (file.read(reinterpret_cast<char*>(buffer.data()), size))
-    {
-        return true;
-    }
-    else
-    {
-        std::cerr << "Failed to read file: " << filepath << std::endl;
-        return false;
-    }
-}
-
-Mat conv2_input(1, 3, 150, 150); 
-Mat conv2_output(1, 32, 150, 150);
-
+// ȨĿ¼CMake ʱΪԴе operators/src ľ·
+#ifndef OPERATORS_WEIGHT_DIR
+#define OPERATORS_WEIGHT_DIR "src"
+#endif
 
-std::vector<int> conv_kernel_size = { 5,5 };
-std::vector<int> conv_stride = { 1,1 };
-int padding = 2;
+// conv1 : 3x150x150 -> 32x150x150, 5x5, stride 1, padding 2
+const int IN_C = 3, IN_H = 150, IN_W = 150;
+const int OUT_C = 32, K = 5, STRIDE = 1, PAD = 2;
 
-void pretensor( Mat& input)
+int main(int argc, char* argv[])
 {
-    for (int i = 0; i < input.channel; ++i)
+    // вȡ߳ĬΪ20--tune µŲд뻺棻
+    // --qps <б|auto> [--requests N] Ϊزԣ
+    // --bind none|compact|spread ɳˣ--mem first-touch|interleave|node<N> ָ NUMA 
+    int num_threads = 20;
+    bool threads_given = false;
+    bool tune = false;
+    std::string qps_spec;
+    int num_requests = 200;
+    affinity::Binding binding = affinity::BIND_NONE;
+    numa::Policy mem_policy = numa::POLICY_FIRST_TOUCH;
+    int mem_node = 0;
+    for (int a = 1; a < argc; ++a)
     {
-        for (int j = 0; j < input.height; ++j)
+        if (std::strcmp(argv[a], "--bind") == 0 && a + 1 < argc)
         {
-            for (int k = 0; k < input.width; ++k)
-            {
-                int index = i * input.height * input.width + j * input.width + k;
-                float value = std::sin(static_cast<float>(index));
-                input[index] = value;
-            }
+            if (!affinity::parse_binding(argv[++a], binding))
+                std::cerr << "Unknown --bind policy, using none" << std::endl;
+            continue;
         }
-    }
-}
-
-void printMat(Mat& mat)
-{
-    for (int d = 0; d < mat.dim; ++d)
-    {
-        for (int c = 0; c < mat.channel; ++c)
+        if (std::strcmp(argv[a], "--mem") == 0 && a + 1 < argc)
         {
-            for (int h = 0; h < mat.height; ++h)
-            {
-                for (int w = 0; w < mat.width; ++w)
-                {
-                    int index =
-                        d * mat.channel * mat.height * mat.width + c * mat.height * mat.width + h * mat.width + w;
-                    printf("%.5lf ", mat[index]);
-                }
-                std::puts("");
-            }
-            std::puts("");
+            if (!numa::parse_policy(argv[++a], mem_policy, mem_node))
+                std::cerr << "Unknown --mem policy, using first-touch" << std::endl;
+            continue;
         }
-
-        std::puts("");
-    }
-    std::puts("");
-}
-
-double get_current_time()
-{
-    auto now = std::chrono::high_resolution_clock::now();
-    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
-    return usec.count() / 1000.0;
-}
-
-// Żлpadding
-Mat padd(const Mat input, int this_padding)
-{
-    if(this_padding == 0)
-        return input;
-    int new_height = input.height + 2*this_padding;
-    int new_width = input.width + 2*this_padding;
-    Mat new_mat(input.dim, input.channel, new_height, new_width);
-    
-    // ȽΪ0ԲУ
-    std::fill(new_mat.tensor.begin(), new_mat.tensor.end(), 0);
-    
-    // иݣͨ
-    #pragma omp parallel for
-    for (int c = 0; c < input.channel; ++c)
-    {
-        int src_channel_offset = c * input.height * input.width;
-        int dst_channel_offset = c * new_height * new_width;
-        
-        for (int h = 0; h < input.height; ++h)
+        if (std::strcmp(argv[a], "--tune") == 0)
         {
-            // ʹmemcpyÿһУԪظƿ
-            int src_row_offset = src_channel_offset + h * input.width;
-            int dst_row_offset = dst_channel_offset + (h + this_padding) * new_width + this_padding;
-            memcpy(&new_mat.tensor[dst_row_offset], 
-                   &input.tensor[src_row_offset], 
-                   input.width * sizeof(float));
+            tune = true;
+            continue;
         }
-    }
-    return new_mat;
-}
-
-double conv2d(const Mat &input, Mat &output, const std::vector<float> &weight, const std::vector<float> &bias,
-              const std::vector<int> &conv_kernel_size, const std::vector<int> &conv_stride, int conv_padding)
-{
-    double start = get_current_time();
-    
-    // лpadding
-    Mat padded_mat = padd(input, conv_padding);
-    
-    int out_h = output.height;
-    int out_w = output.width;
-    int in_h = padded_mat.height;
-    int in_w = padded_mat.width;
-    int kernel_h = conv_kernel_size[0];
-    int kernel_w = conv_kernel_size[1];
-    int stride_h = conv_stride[0];
-    int stride_w = conv_stride[1];
-    int channel_out = output.channel;
-    int channel_in = padded_mat.channel;
-    int kernel_max = kernel_h * kernel_w;
-    
-    // άռ䲢У = 150  150 = 22,500
-    // ÿ̴߳һλõͨfalse sharing
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int oh = 0; oh < out_h; ++oh) {
-        for (int ow = 0; ow < out_w; ++ow) {
-            int h_start = oh * stride_h;
-            int w_start = ow * stride_w;
-            
-            // ÿͨ
-            for (int oc = 0; oc < channel_out; ++oc) {
-                float sum = 0.0f;
-                
-                // ͨ
-                for (int ic = 0; ic < channel_in; ++ic) {
-                    const float* input_ptr = &padded_mat.tensor[
-                        ic * in_h * in_w + h_start * in_w + w_start];
-                    const float* weight_ptr = &weight[oc * channel_in * kernel_max + ic * kernel_max];
-                    
-                    // 55ȫֶչ25
-                    sum += weight_ptr[0] * input_ptr[0];
-                    sum += weight_ptr[1] * input_ptr[1];
-                    sum += weight_ptr[2] * input_ptr[2];
-                    sum += weight_ptr[3] * input_ptr[3];
-                    sum += weight_ptr[4] * input_ptr[4];
-                    
-                    sum += weight_ptr[5] * input_ptr[in_w];
-                    sum += weight_ptr[6] * input_ptr[in_w + 1];
-                    sum += weight_ptr[7] * input_ptr[in_w + 2];
-                    sum += weight_ptr[8] * input_ptr[in_w + 3];
-                    sum += weight_ptr[9] * input_ptr[in_w + 4];
-                    
-                    sum += weight_ptr[10] * input_ptr[2 * in_w];
-                    sum += weight_ptr[11] * input_ptr[2 * in_w + 1];
-                    sum += weight_ptr[12] * input_ptr[2 * in_w + 2];
-                    sum += weight_ptr[13] * input_ptr[2 * in_w + 3];
-                    sum += weight_ptr[14] * input_ptr[2 * in_w + 4];
-                    
-                    sum += weight_ptr[15] * input_ptr[3 * in_w];
-                    sum += weight_ptr[16] * input_ptr[3 * in_w + 1];
-                    sum += weight_ptr[17] * input_ptr[3 * in_w + 2];
-                    sum += weight_ptr[18] * input_ptr[3 * in_w + 3];
-                    sum += weight_ptr[19] * input_ptr[3 * in_w + 4];
-                    
-                    sum += weight_ptr[20] * input_ptr[4 * in_w];
-                    sum += weight_ptr[21] * input_ptr[4 * in_w + 1];
-                    sum += weight_ptr[22] * input_ptr[4 * in_w + 2];
-                    sum += weight_ptr[23] * input_ptr[4 * in_w + 3];
-                    sum += weight_ptr[24] * input_ptr[4 * in_w + 4];
-                }
-                
-                // ŻֱӼbiasд룬
-                output.tensor[oc * out_h * out_w + oh * out_w + ow] = sum + bias[oc];
-            }
+        if (std::strcmp(argv[a], "--qps") == 0 && a + 1 < argc)
+        {
+            qps_spec = argv[++a];
+            continue;
         }
-    }
-    
-    double end = get_current_time();
-    return (end - start);
-}
-
-
-
-
-int main(int argc, char* argv[])
-{
-    // вȡ߳ĬΪ20
-    int num_threads = 20;
-    if (argc > 1)
-    {
-        num_threads = std::atoi(argv[1]);
+        if (std::strcmp(argv[a], "--requests") == 0 && a + 1 < argc)
+        {
+            num_requests = std::max(1, std::atoi(argv[++a]));
+            continue;
+        }
+        num_threads = std::atoi(argv[a]);
+        threads_given = true;
         if (num_threads <= 0)
         {
             std::cerr << "Invalid thread count. Using default: 20" << std::endl;
@@ -259,27 +74,90 @@ int main(int argc, char* argv[])
         }
     }
     omp_set_num_threads(num_threads);
-    //std::cout << "Using " << num_threads << " threads" << std::endl;
-    //std::cout << "2D spatial parallelism + Optimized padding + Fused bias" << std::endl;
     
-    std::vector<float> conv2_weight(32 * 3 * 5 * 5);
-    std::vector<float> conv2_bias(32);
-    std::string conv2_weight_path = ".\\src" PATH_SEPARATOR "conv1.weight.bin";
-    std::string conv2_bias_path = ".\\src" PATH_SEPARATOR "conv1.bias.bin";
-    readBinaryFile(conv2_weight_path, conv2_weight);
-    readBinaryFile(conv2_bias_path, conv2_bias);
-    pretensor(conv2_input);
+    // Ӳ OpenMP ̳߳ش֮ǰ
+    perfc::PerfCounters counters;
+    
+    ops::Conv2d conv1(ops::Conv2dParams(IN_C, OUT_C, K, STRIDE, PAD));
+    conv1.set_name("conv1");
+    conv1.load_weights(OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.weight.bin",
+                       OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.bias.bin");
+    
+    // ȡŻ棺ʹûѭ˳/ֿ飬ʽ߳
+    convtune::ConvConfig conv_config = convtune::default_config(num_threads);
+    convtune::TuningCache tuning_cache;
+    tuning_cache.load();
+    convtune::ConvShape shape = conv1.shape_for(IN_H, IN_W);
+    if (!tune && tuning_cache.lookup(shape, conv_config) && threads_given)
+        conv_config.num_threads = num_threads;
+    
+    // ڵһĲ֮ǰˣ֮ first-touch ÿɹ̶ϵͬһ߳
+    if (binding != affinity::BIND_NONE)
+    {
+        int team = std::max(num_threads, conv_config.num_threads);
+        if (!affinity::pin_omp_team(affinity::plan_cpus(team, binding)))
+            std::cerr << "Thread pinning failed" << std::endl;
+    }
+    std::cout << "Binding: " << affinity::binding_name(binding)
+              << ", memory: " << numa::policy_name(mem_policy) << std::endl;
+    
+    // Դ PAD ߿д view()ڲ򣩣 padded_view() padding 
+    ops::Tensor conv2_input(1, IN_C, IN_H, IN_W, PAD);
+    ops::Tensor conv2_output(1, OUT_C, conv1.out_h(IN_H), conv1.out_w(IN_W));
+    conv2_input.place(mem_policy, mem_node);
+    conv2_output.place(mem_policy, mem_node);
+    ops::fill_sin(conv2_input.view());
+    
+    // һԹȨؿ䣩 prepare ɣÿ
+    conv1.prepare(IN_H, IN_W, conv_config);
+    if (tune)
+    {
+        double best_ms = 0.0;
+        std::cout << "Autotuning " << shape.key() << " (up to " << num_threads << " threads)..." << std::endl;
+        conv_config = conv1.autotune(conv2_input.view(), conv2_output.view(), num_threads, best_ms);
+        tuning_cache.put(shape, conv_config, best_ms);
+        if (tuning_cache.save())
+            std::cout << "Tuning cache written to " << tuning_cache.path() << std::endl;
+    }
+    std::cout << "Conv config: " << convtune::config_string(conv_config) << std::endl;
+    
+    ops::TensorView input_view = conv2_input.padded_view();
+    ops::TensorView output_view = conv2_output.view();
+    auto conv2d = [&]() -> double {
+        double start = ops::now_ms();
+        conv1.execute_padded(input_view, output_view);
+        return ops::now_ms() - start;
+    };
     
     // 250βԣǰ50Ԥȣ200μλP99
     const int total_iterations = 250;
     const int warmup_iterations = 50;
     double times[total_iterations];
     
+    // ģʽɵ·ӳٺŶʱ䣬-ӳ
+    if (!qps_spec.empty())
+    {
+        for (int i = 0; i < warmup_iterations; ++i)
+        {
+            times[i] = conv2d();
+        }
+        std::sort(times, times + warmup_iterations);
+        double service_ms = times[warmup_iterations / 2];
+        std::vector<double> qps_list = loadgen::parse_qps_list(qps_spec, service_ms);
+        std::cout << "Open-loop load test: service time " << service_ms << " ms, "
+                  << num_requests << " requests per point" << std::endl;
+        loadgen::sweep([&]() {
+            conv2d();
+        }, qps_list, num_requests, "conv_latency_curve.csv");
+        prof::Profiler::instance().dump();
+        return 0;
+    }
+    
     for (int i = 0; i < total_iterations; ++i)
     {
-        // 
-        std::fill(conv2_output.tensor.begin(), conv2_output.tensor.end(), 0);
-        times[i] = conv2d(conv2_input, conv2_output, conv2_weight, conv2_bias, conv_kernel_size, conv_stride, padding);
+        if (i >= warmup_iterations) counters.start();
+        times[i] = conv2d();
+        if (i >= warmup_iterations) counters.stop();
     }
     
     // ȡ200εʱݲ
@@ -310,6 +188,7 @@ int main(int argc, char* argv[])
     
     std::cout << "Median time (after warmup): " << median << " ms" << std::endl;
     std::cout << "P99 time (after warmup): " << p99 << " ms" << std::endl;
-    //printMat(conv2_output);
+    counters.print_summary(std::cout, valid_count);
+    prof::Profiler::instance().dump();
     return 0;
 }
@@ -0,0 +1,251 @@
+// 多实例推理服务测试：K 个独立的 conv1 引擎实例，各自绑定到互不重叠的核心组，
+// 拥有自己的内存区（padding 输入、输出、权重副本），共同消费一个请求队列。
+// 请求按给定到达率（泊松过程）生成，报告总吞吐量和端到端延迟（含排队时间）。
+//
+// 用法: conv_serving <实例数K> <每实例线程数> <到达率 req/s，0 表示全部请求同时到达> <请求数>
+// 例如 20 核机器: conv_serving 4 5 200 2000  对比  conv_serving 1 20 200 2000
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <omp.h>
+#include "ops.h"
+#include "loadgen.h"
+#include "../common/affinity.h"
+
+#if defined(_WIN32)
+#define PATH_SEPARATOR "\\"
+#else
+#define PATH_SEPARATOR "/"
+#endif
+
+#ifndef OPERATORS_WEIGHT_DIR
+#define OPERATORS_WEIGHT_DIR "src"
+#endif
+
+typedef std::chrono::steady_clock serve_clock;
+
+// conv1 层: 3x150x150 -> 32x150x150, 5x5, stride 1, padding 2
+const int IN_C = 3, IN_H = 150, IN_W = 150;
+const int OUT_C = 32, K = 5, PAD = 2;
+
+// 请求队列：到达时间戳（ms，相对于开始时刻）
+struct RequestQueue
+{
+    std::deque<double> arrivals;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool closed = false;
+
+    void push(double t)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrivals.push_back(t);
+        }
+        cv.notify_one();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        cv.notify_all();
+    }
+
+    // 队列已关闭且为空时返回 false
+    bool pop(double& t)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return closed || !arrivals.empty(); });
+        if (arrivals.empty())
+            return false;
+        t = arrivals.front();
+        arrivals.pop_front();
+        return true;
+    }
+};
+
+// 单个引擎实例：独立的核心组和内存区
+struct EngineInstance
+{
+    int id;
+    std::vector<int> cpus;
+    convtune::ConvConfig config;
+    ops::Tensor input;
+    ops::Tensor output;
+    std::unique_ptr<ops::Conv2d> conv;
+    std::vector<double> latencies;
+    bool pinned = false;
+
+    // 在实例自己的线程上调用：先绑核，再 prepare（权重副本、padding 工作区），保证首次访问在本地核心
+    void setup(const std::vector<float>& weight_src, const std::vector<float>& bias_src)
+    {
+        pinned = affinity::pin_current_thread(cpus[0]);
+        pinned = affinity::pin_omp_team(cpus) && pinned;
+
+        conv.reset(new ops::Conv2d(ops::Conv2dParams(IN_C, OUT_C, K, 1, PAD)));
+        conv->set_weights(weight_src.data(), bias_src.data());
+        conv->prepare(IN_H, IN_W, config);
+        input = ops::Tensor(1, IN_C, IN_H, IN_W);
+        output = ops::Tensor(1, OUT_C, conv->out_h(IN_H), conv->out_w(IN_W));
+        for (size_t i = 0; i < input.size(); ++i)
+            input[i] = std::sin(static_cast<float>(i + id));
+    }
+
+    void infer()
+    {
+        conv->execute(input.view(), output.view());
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    int num_cpus = affinity::num_cpus();
+    int instances = argc > 1 ? std::atoi(argv[1]) : 4;
+    if (instances <= 0)
+        instances = 1;
+    int threads_per_instance = argc > 2 ? std::atoi(argv[2]) : std::max(1, num_cpus / instances);
+    if (threads_per_instance <= 0)
+        threads_per_instance = 1;
+    double rate = argc > 3 ? std::atof(argv[3]) : 0.0;
+    int num_requests = argc > 4 ? std::atoi(argv[4]) : 400;
+    if (num_requests <= 0)
+        num_requests = 400;
+
+    if (instances * threads_per_instance > num_cpus)
+    {
+        std::cerr << "Warning: " << instances << " x " << threads_per_instance
+                  << " threads exceeds " << num_cpus << " CPUs, core sets will overlap" << std::endl;
+    }
+
+    std::vector<float> weight(OUT_C * IN_C * K * K);
+    std::vector<float> bias(OUT_C);
+    if (!ops::read_binary_file(OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.weight.bin", weight) ||
+        !ops::read_binary_file(OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv1.bias.bin", bias) ||
+        weight.size() != (size_t)(OUT_C * IN_C * K * K) || bias.size() != (size_t)OUT_C)
+    {
+        std::cerr << "Using synthetic weights" << std::endl;
+        weight.resize(OUT_C * IN_C * K * K);
+        bias.resize(OUT_C);
+        for (size_t i = 0; i < weight.size(); ++i)
+            weight[i] = std::cos(static_cast<float>(i)) * 0.1f;
+        for (size_t i = 0; i < bias.size(); ++i)
+            bias[i] = 0.01f * i;
+    }
+
+    convtune::ConvShape shape = ops::Conv2d(ops::Conv2dParams(IN_C, OUT_C, K, 1, PAD)).shape_for(IN_H, IN_W);
+
+    // 调优缓存命中则复用其循环顺序/分块，线程数固定为每实例线程数
+    convtune::ConvConfig config = convtune::default_config(threads_per_instance);
+    convtune::TuningCache tuning_cache;
+    tuning_cache.load();
+    tuning_cache.lookup(shape, config);
+    config.num_threads = threads_per_instance;
+
+    std::cout << "Instances: " << instances << " x " << threads_per_instance << " threads, arrival rate: ";
+    if (rate > 0)
+        std::cout << rate << " req/s";
+    else
+        std::cout << "burst";
+    std::cout << ", requests: " << num_requests << std::endl;
+    std::cout << "Conv config: " << convtune::config_string(config) << std::endl;
+
+    // 按 NUMA 节点顺序连续分配核心，实例尽量不跨插槽；实例的内存由绑核后的线程 first-touch，落在本节点
+    std::vector<int> all_cpus = affinity::plan_cpus(instances * threads_per_instance, affinity::BIND_COMPACT);
+    std::vector<EngineInstance> engines(instances);
+    for (int k = 0; k < instances; ++k)
+    {
+        engines[k].id = k;
+        engines[k].cpus.assign(all_cpus.begin() + k * threads_per_instance,
+                               all_cpus.begin() + (k + 1) * threads_per_instance);
+        engines[k].config = config;
+    }
+
+    RequestQueue queue;
+    const int warmup_per_instance = 5;
+    serve_clock::time_point t0;
+    std::mutex ready_mutex;
+    std::condition_variable ready_cv;
+    int ready = 0;
+    bool go = false;
+
+    std::vector<std::thread> workers;
+    for (int k = 0; k < instances; ++k)
+    {
+        workers.push_back(std::thread([&, k]() {
+            EngineInstance& e = engines[k];
+            e.setup(weight, bias);
+            for (int w = 0; w < warmup_per_instance; ++w)
+                e.infer();
+            {
+                std::unique_lock<std::mutex> lock(ready_mutex);
+                ++ready;
+                ready_cv.notify_all();
+                ready_cv.wait(lock, [&] { return go; });
+            }
+            double arrival;
+            while (queue.pop(arrival))
+            {
+                e.infer();
+                double done = std::chrono::duration<double, std::milli>(serve_clock::now() - t0).count();
+                e.latencies.push_back(done - arrival);
+            }
+        }));
+    }
+
+    // 所有实例完成初始化和预热后开始计时
+    {
+        std::unique_lock<std::mutex> lock(ready_mutex);
+        ready_cv.wait(lock, [&] { return ready == instances; });
+        t0 = serve_clock::now();
+        go = true;
+        ready_cv.notify_all();
+    }
+
+    // 请求生成：泊松到达（开环，与服务进度无关），rate <= 0 时全部在 t=0 到达
+    std::vector<double> arrivals(num_requests, 0.0);
+    if (rate > 0)
+        arrivals = loadgen::poisson_arrivals(rate, num_requests);
+    for (int r = 0; r < num_requests; ++r)
+    {
+        if (rate > 0)
+            std::this_thread::sleep_until(t0 + std::chrono::nanoseconds((long long)(arrivals[r] * 1e6)));
+        queue.push(arrivals[r]);
+    }
+    queue.close();
+
+    for (size_t k = 0; k < workers.size(); ++k)
+        workers[k].join();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(serve_clock::now() - t0).count();
+
+    loadgen::HdrHistogram all;
+    for (int k = 0; k < instances; ++k)
+    {
+        loadgen::HdrHistogram hist;
+        for (size_t r = 0; r < engines[k].latencies.size(); ++r)
+        {
+            hist.record_ms(engines[k].latencies[r]);
+            all.record_ms(engines[k].latencies[r]);
+        }
+        std::cout << "  instance " << k << " cpus [" << engines[k].cpus.front() << "-" << engines[k].cpus.back()
+                  << "]" << (engines[k].pinned ? "" : " (not pinned)")
+                  << ": " << hist.total_count() << " requests, median "
+                  << hist.percentile_ms(50.0) << " ms" << std::endl;
+    }
+
+    std::cout << "Throughput: " << all.total_count() / (elapsed_ms / 1000.0) << " req/s" << std::endl;
+    std::cout << "Median latency: " << all.percentile_ms(50.0) << " ms" << std::endl;
+    std::cout << "P99 latency: " << all.percentile_ms(99.0) << " ms" << std::endl;
+    std::cout << "P99.9 latency: " << all.percentile_ms(99.9) << " ms" << std::endl;
+    return 0;
+}
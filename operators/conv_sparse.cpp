@@ -0,0 +1,121 @@
+// 稀疏卷积测试：conv6（128 -> 128，3x3）按幅值剪枝到不同稀疏度，
+// 比较稠密内核和稀疏内核的中位数耗时和结果误差，并给出按默认阈值自动选择的内核。
+// 任一稀疏度下两个内核的结果误差超过容差时以非零状态退出。
+//
+// 用法: conv_sparse [线程数] [空间尺寸，默认 37]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <omp.h>
+#include "ops.h"
+
+#if defined(_WIN32)
+#define PATH_SEPARATOR "\\"
+#else
+#define PATH_SEPARATOR "/"
+#endif
+
+#ifndef OPERATORS_WEIGHT_DIR
+#define OPERATORS_WEIGHT_DIR "src"
+#endif
+
+// conv6 层: 128x37x37 -> 128x37x37, 3x3, stride 1, padding 1
+const int C = 128, K = 3, PAD = 1;
+
+static double median_ms(ops::Conv2d& conv, const ops::TensorView& in, const ops::TensorView& out, int repeats)
+{
+    conv.execute_padded(in, out);  // 预热
+    std::vector<double> times(repeats);
+    for (int r = 0; r < repeats; ++r)
+    {
+        double t0 = ops::now_ms();
+        conv.execute_padded(in, out);
+        times[r] = ops::now_ms() - t0;
+    }
+    std::sort(times.begin(), times.end());
+    return times[repeats / 2];
+}
+
+int main(int argc, char* argv[])
+{
+    int num_threads = argc > 1 ? std::atoi(argv[1]) : omp_get_max_threads();
+    int size = argc > 2 ? std::atoi(argv[2]) : 37;
+    if (num_threads <= 0 || size <= 0)
+    {
+        std::cerr << "用法: " << argv[0] << " [线程数] [空间尺寸]" << std::endl;
+        return 1;
+    }
+
+    std::vector<float> weight, bias;
+    if (!ops::read_binary_file(OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv6.weight.bin", weight) ||
+        !ops::read_binary_file(OPERATORS_WEIGHT_DIR PATH_SEPARATOR "conv6.bias.bin", bias) ||
+        weight.size() != (size_t)C * C * K * K || bias.size() != (size_t)C)
+    {
+        std::cerr << "Failed to load conv6 weights" << std::endl;
+        return 1;
+    }
+
+    ops::Tensor input(1, C, size, size, PAD);
+    ops::fill_sin(input.view());
+    ops::Tensor out_dense(1, C, size, size), out_sparse(1, C, size, size);
+
+    // 两个内核使用相同的通道分块
+    convtune::ConvConfig cfg;
+    cfg.loop_order = convtune::LOOP_CHANNEL;
+    cfg.tile_oc = 4;
+    cfg.tile_oh = 4;
+    cfg.tile_ow = size;
+    cfg.num_threads = num_threads;
+
+    std::cout << "conv6 " << C << "x" << size << "x" << size << " -> " << C << ", k" << K
+              << ", threads " << num_threads << ", sparse threshold " << convtune::default_sparse_threshold()
+              << std::endl;
+    std::cout << "sparsity  dense_ms  sparse_ms  speedup  max_err  auto" << std::endl;
+
+    int failures = 0;
+    const double fractions[] = { 0.0, 0.5, 0.7, 0.8, 0.9, 0.95 };
+    for (size_t f = 0; f < sizeof(fractions) / sizeof(fractions[0]); ++f)
+    {
+        std::vector<float> pruned = weight;
+        convtune::prune_magnitude(pruned, fractions[f]);
+
+        ops::Conv2d dense(ops::Conv2dParams(C, C, K, 1, PAD));
+        ops::Conv2d sparse(ops::Conv2dParams(C, C, K, 1, PAD));
+        ops::Conv2d chosen(ops::Conv2dParams(C, C, K, 1, PAD));
+        dense.set_sparse_threshold(2.0);
+        sparse.set_sparse_threshold(0.0);
+        dense.set_weights(pruned.data(), bias.data());
+        sparse.set_weights(pruned.data(), bias.data());
+        chosen.set_weights(pruned.data(), bias.data());
+        dense.prepare(size, size, cfg);
+        sparse.prepare(size, size, cfg);
+
+        double t_dense = median_ms(dense, input.padded_view(), out_dense.view(), 20);
+        double t_sparse = median_ms(sparse, input.padded_view(), out_sparse.view(), 20);
+
+        double max_err = 0.0, max_out = 0.0;
+        for (size_t i = 0; i < out_dense.size(); ++i)
+        {
+            max_err = std::max(max_err, (double)std::fabs(out_dense[i] - out_sparse[i]));
+            max_out = std::max(max_out, (double)std::fabs(out_dense[i]));
+        }
+        // 与 test_conv_regression 相同：float 累加顺序不同，容差按输出量级和累加长度放宽
+        bool ok = max_err <= 1e-6 * C * K * K * std::max(1.0, max_out);
+        if (!ok)
+            ++failures;
+
+        std::cout << dense.sparsity() << "  " << t_dense << "  " << t_sparse << "  "
+                  << t_dense / t_sparse << "x  " << max_err << (ok ? "" : " FAIL") << "  "
+                  << (chosen.is_sparse() ? "sparse" : "dense") << std::endl;
+    }
+
+    if (failures > 0)
+    {
+        std::cout << failures << " sparsity level(s) exceed the error tolerance" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,274 @@
+#ifndef OPERATORS_LOADGEN_H
+#define OPERATORS_LOADGEN_H
+
+// 开环负载生成：按泊松过程（指数分布间隔）预先生成到达时刻，与服务完成时刻无关，
+// 延迟从“计划到达时刻”算起，包含排队时间，避免闭环测试的 coordinated omission。
+// 延迟用 HDR 直方图（3 位有效数字）统计 p50/p99/p99.9，多个 QPS 点组成吞吐-延迟曲线。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace loadgen {
+
+// HdrHistogram 的简化实现：值以纳秒记录，最大可记录 1 小时，相对误差 < 0.1%
+class HdrHistogram
+{
+public:
+    explicit HdrHistogram(int64_t highest_trackable = 3600LL * 1000000000LL)
+        : highest_(highest_trackable), total_(0), max_(0), sum_(0.0)
+    {
+        // 3 位有效数字：2 * 10^3 向上取 2 的幂 = 2048 个子桶
+        sub_bucket_half_magnitude_ = 10;
+        sub_bucket_half_count_ = 1 << sub_bucket_half_magnitude_;
+        sub_bucket_count_ = sub_bucket_half_count_ * 2;
+        sub_bucket_mask_ = (int64_t)sub_bucket_count_ - 1;
+
+        int64_t smallest_untrackable = (int64_t)sub_bucket_count_;
+        bucket_count_ = 1;
+        while (smallest_untrackable <= highest_)
+        {
+            if (smallest_untrackable > INT64_MAX / 2)
+            {
+                ++bucket_count_;
+                break;
+            }
+            smallest_untrackable <<= 1;
+            ++bucket_count_;
+        }
+        counts_.assign((size_t)(bucket_count_ + 1) * sub_bucket_half_count_, 0);
+    }
+
+    void record(int64_t value)
+    {
+        if (value < 0)
+            value = 0;
+        if (value > highest_)
+            value = highest_;
+        counts_[counts_index(value)] += 1;
+        total_ += 1;
+        sum_ += (double)value;
+        if (value > max_)
+            max_ = value;
+    }
+
+    void record_ms(double ms) { record((int64_t)(ms * 1e6)); }
+
+    int64_t total_count() const { return total_; }
+    double mean_ms() const { return total_ > 0 ? sum_ / total_ * 1e-6 : 0.0; }
+    double max_ms() const { return max_ * 1e-6; }
+
+    // 百分位 p ∈ [0, 100]，返回等价区间上界（ms）
+    double percentile_ms(double p) const
+    {
+        if (total_ == 0)
+            return 0.0;
+        int64_t target = (int64_t)std::ceil(p / 100.0 * (double)total_);
+        if (target < 1)
+            target = 1;
+        int64_t running = 0;
+        for (size_t i = 0; i < counts_.size(); ++i)
+        {
+            running += counts_[i];
+            if (running >= target)
+            {
+                int64_t v = highest_equivalent_value(value_at_index((int)i));
+                return std::min(v, max_) * 1e-6;
+            }
+        }
+        return max_ * 1e-6;
+    }
+
+    void reset()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        max_ = 0;
+        sum_ = 0.0;
+    }
+
+private:
+    int bucket_index(int64_t value) const
+    {
+        int pow2ceiling = 64 - __builtin_clzll((unsigned long long)(value | sub_bucket_mask_));
+        return pow2ceiling - (sub_bucket_half_magnitude_ + 1);
+    }
+
+    int counts_index(int64_t value) const
+    {
+        int bi = bucket_index(value);
+        int sbi = (int)(value >> bi);
+        return ((bi + 1) << sub_bucket_half_magnitude_) + (sbi - sub_bucket_half_count_);
+    }
+
+    int64_t value_at_index(int index) const
+    {
+        int bi = (index >> sub_bucket_half_magnitude_) - 1;
+        int sbi = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+        if (bi < 0)
+        {
+            sbi -= sub_bucket_half_count_;
+            bi = 0;
+        }
+        return (int64_t)sbi << bi;
+    }
+
+    int64_t highest_equivalent_value(int64_t value) const
+    {
+        int bi = bucket_index(value);
+        int sbi = (int)(value >> bi);
+        int adjusted = (sbi >= sub_bucket_count_) ? bi + 1 : bi;
+        int64_t lowest = (int64_t)sbi << bi;
+        return lowest + ((int64_t)1 << adjusted) - 1;
+    }
+
+    int64_t highest_;
+    int sub_bucket_half_magnitude_;
+    int sub_bucket_half_count_;
+    int sub_bucket_count_;
+    int64_t sub_bucket_mask_;
+    int bucket_count_;
+    std::vector<int64_t> counts_;
+    int64_t total_;
+    int64_t max_;
+    double sum_;
+};
+
+// 泊松到达时刻（ms，从 0 开始）
+inline std::vector<double> poisson_arrivals(double qps, int n, unsigned seed = 12345)
+{
+    std::vector<double> arrivals(n);
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> gap(qps);
+    double t = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        t += gap(rng) * 1000.0;
+        arrivals[i] = t;
+    }
+    return arrivals;
+}
+
+// 吞吐-延迟曲线上的一个点
+struct LoadPoint
+{
+    double offered_qps;
+    double achieved_qps;
+    double p50_ms;
+    double p99_ms;
+    double p999_ms;
+    double max_ms;
+    double mean_ms;
+};
+
+// 单服务者开环测试：请求按计划时刻到达，服务者空闲时等到下一个到达时刻，
+// 忙碌时到达的请求在队列中等待；延迟 = 完成时刻 - 计划到达时刻
+template <typename InferFn>
+LoadPoint run_open_loop(InferFn infer, double qps, int num_requests, unsigned seed = 12345)
+{
+    typedef std::chrono::steady_clock clock;
+    std::vector<double> arrivals = poisson_arrivals(qps, num_requests, seed);
+    HdrHistogram hist;
+
+    clock::time_point t0 = clock::now();
+    double last_done = 0.0;
+    for (int i = 0; i < num_requests; ++i)
+    {
+        clock::time_point target = t0 + std::chrono::nanoseconds((long long)(arrivals[i] * 1e6));
+        if (clock::now() < target)
+            std::this_thread::sleep_until(target);
+        infer();
+        last_done = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+        hist.record_ms(last_done - arrivals[i]);
+    }
+
+    LoadPoint p;
+    p.offered_qps = qps;
+    p.achieved_qps = last_done > 0 ? num_requests / (last_done / 1000.0) : 0.0;
+    p.p50_ms = hist.percentile_ms(50.0);
+    p.p99_ms = hist.percentile_ms(99.0);
+    p.p999_ms = hist.percentile_ms(99.9);
+    p.max_ms = hist.max_ms();
+    p.mean_ms = hist.mean_ms();
+    return p;
+}
+
+// 解析 "--qps" 参数：逗号分隔的 QPS 列表，或 "auto" 表示按容量（1000 / 单次服务时间）的比例扫描
+inline std::vector<double> parse_qps_list(const std::string& spec, double service_ms)
+{
+    std::vector<double> qps;
+    if (spec == "auto")
+    {
+        double capacity = service_ms > 0 ? 1000.0 / service_ms : 1.0;
+        const double loads[] = { 0.1, 0.3, 0.5, 0.7, 0.8, 0.9, 0.95, 1.0, 1.1 };
+        for (size_t i = 0; i < sizeof(loads) / sizeof(loads[0]); ++i)
+            qps.push_back(capacity * loads[i]);
+        return qps;
+    }
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        double q = std::atof(item.c_str());
+        if (q > 0)
+            qps.push_back(q);
+    }
+    return qps;
+}
+
+inline void print_header()
+{
+    std::printf("%12s %12s %10s %10s %10s %10s\n", "offered_qps", "achieved", "p50_ms", "p99_ms", "p99.9_ms", "max_ms");
+}
+
+inline void print_point(const LoadPoint& p)
+{
+    std::printf("%12.2f %12.2f %10.3f %10.3f %10.3f %10.3f\n",
+                p.offered_qps, p.achieved_qps, p.p50_ms, p.p99_ms, p.p999_ms, p.max_ms);
+}
+
+inline bool write_curve_csv(const std::string& path, const std::vector<LoadPoint>& curve)
+{
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+    std::fprintf(fp, "offered_qps,achieved_qps,mean_ms,p50_ms,p99_ms,p999_ms,max_ms\n");
+    for (size_t i = 0; i < curve.size(); ++i)
+    {
+        const LoadPoint& p = curve[i];
+        std::fprintf(fp, "%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                     p.offered_qps, p.achieved_qps, p.mean_ms, p.p50_ms, p.p99_ms, p.p999_ms, p.max_ms);
+    }
+    std::fclose(fp);
+    return true;
+}
+
+// 完整扫描：逐个 QPS 点运行开环测试，打印表格并写出曲线 CSV
+template <typename InferFn>
+std::vector<LoadPoint> sweep(InferFn infer, const std::vector<double>& qps_list, int num_requests,
+                             const std::string& csv_path)
+{
+    std::vector<LoadPoint> curve;
+    print_header();
+    for (size_t i = 0; i < qps_list.size(); ++i)
+    {
+        LoadPoint p = run_open_loop(infer, qps_list[i], num_requests, 12345u + (unsigned)i);
+        print_point(p);
+        curve.push_back(p);
+    }
+    if (write_curve_csv(csv_path, curve))
+        std::printf("Latency curve written to %s\n", csv_path.c_str());
+    return curve;
+}
+
+} // namespace loadgen
+
+#endif // OPERATORS_LOADGEN_H
@@ -0,0 +1,251 @@
+#ifndef OPERATORS_MODEL_H
+#define OPERATORS_MODEL_H
+
+// 多层卷积模型及其启动流程。
+//
+// startup() 把冷启动拆成四步并分别计时：
+//   load      读取全部层的 .bin 权重（并行：每个文件一个任务）
+//   prepare   每层 Conv2d 拷贝权重（并行：每层一个任务），再逐层分配工作区和激活缓冲区
+//             （顶层调用，每层由完整的线程组按执行时的划分 first-touch）
+//   prefault  并行触碰所有激活缓冲区，缺页在启动时而不是第一次请求时发生
+//   warmup    用合成输入完整前向一次，预热缓存、分支预测和 OpenMP 线程池
+// 关闭对应选项即得到原来的顺序启动方式，便于对比。
+//
+// 层之间零拷贝：卷积直接写入下一层带零边框输入的内部区域，池化同理。
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "ops.h"
+#include "../common/affinity.h"
+
+#if defined(_WIN32)
+#define OPS_MODEL_PATH_SEPARATOR "\\"
+#else
+#define OPS_MODEL_PATH_SEPARATOR "/"
+#endif
+
+namespace ops {
+
+struct LayerSpec
+{
+    std::string name;   // 权重文件前缀：<name>.weight.bin / <name>.bias.bin
+    int c_in;
+    int c_out;
+    int kernel;
+    int pad;
+    bool pool_after;    // 之后接 2x2、步长 2 的平均池化
+};
+
+// operators/src 中 conv1..conv8 的卷积主干，通道数和卷积核由权重文件大小确定；
+// 原网络的空间结构没有随权重导出，这里假设每两层卷积后做一次 2x2 池化
+inline std::vector<LayerSpec> default_backbone()
+{
+    std::vector<LayerSpec> layers;
+    const LayerSpec table[] = {
+        { "conv1", 3, 32, 5, 2, false },
+        { "conv2", 32, 32, 5, 2, true },
+        { "conv3", 32, 64, 5, 2, false },
+        { "conv4", 64, 64, 5, 2, true },
+        { "conv5", 64, 128, 3, 1, false },
+        { "conv6", 128, 128, 3, 1, true },
+        { "conv7", 128, 128, 3, 1, false },
+        { "conv8", 128, 128, 3, 1, true },
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i)
+        layers.push_back(table[i]);
+    return layers;
+}
+
+struct StartupOptions
+{
+    bool parallel;   // 并行读取权重和准备各层
+    bool prefault;   // 启动时触碰激活缓冲区
+    bool warmup;     // 启动时合成输入前向一次
+    affinity::Binding binding;  // 启动前绑定 OpenMP 线程组，激活缓冲区由绑核后的线程 first-touch
+
+    StartupOptions() : parallel(true), prefault(true), warmup(true), binding(affinity::BIND_NONE) {}
+};
+
+struct StartupStats
+{
+    double load_ms;
+    double prepare_ms;
+    double prefault_ms;
+    double warmup_ms;
+    double total_ms;
+
+    StartupStats() : load_ms(0), prepare_ms(0), prefault_ms(0), warmup_ms(0), total_ms(0) {}
+};
+
+class ConvModel
+{
+public:
+    ConvModel(const std::vector<LayerSpec>& layers, int in_h, int in_w)
+        : layers_(layers), in_h_(in_h), in_w_(in_w), num_threads_(1)
+    {
+        int h = in_h, w = in_w;
+        for (size_t i = 0; i < layers_.size(); ++i)
+        {
+            heights_.push_back(h);
+            widths_.push_back(w);
+            if (layers_[i].pool_after)
+            {
+                h = h / 2;
+                w = w / 2;
+            }
+        }
+        out_h_ = h;
+        out_w_ = w;
+    }
+
+    int num_layers() const { return (int)layers_.size(); }
+
+    bool startup(const std::string& weight_dir, int num_threads, const StartupOptions& opt, StartupStats& stats)
+    {
+        num_threads_ = num_threads;
+        const int n = num_layers();
+        double t0 = now_ms();
+        if (opt.binding != affinity::BIND_NONE)
+            affinity::pin_omp_team(affinity::plan_cpus(num_threads, opt.binding));
+
+        // 1. 读取权重
+        std::vector<std::vector<float> > files(2 * n);
+        std::vector<char> ok(2 * n, 0);
+        #pragma omp parallel for schedule(dynamic) num_threads(num_threads) if(opt.parallel)
+        for (int f = 0; f < 2 * n; ++f)
+        {
+            std::string path = weight_dir + OPS_MODEL_PATH_SEPARATOR + layers_[f / 2].name +
+                               (f % 2 == 0 ? ".weight.bin" : ".bias.bin");
+            ok[f] = read_binary_file(path, files[f]) ? 1 : 0;
+        }
+        for (int f = 0; f < 2 * n; ++f)
+        {
+            if (!ok[f])
+                return false;
+        }
+        double t1 = now_ms();
+
+        // 2. 各层准备：权重拷贝（只读，与放置无关）按层并行
+        convs_.clear();
+        convs_.resize(n);
+        std::vector<char> shape_ok(n, 0);
+        #pragma omp parallel for schedule(dynamic) num_threads(num_threads) if(opt.parallel)
+        for (int i = 0; i < n; ++i)
+        {
+            const LayerSpec& l = layers_[i];
+            Conv2d* conv = new Conv2d(Conv2dParams(l.c_in, l.c_out, l.kernel, 1, l.pad));
+            conv->set_name(l.name);
+            convs_[i].reset(conv);
+            if (files[2 * i].size() != (size_t)l.c_out * l.c_in * l.kernel * l.kernel ||
+                files[2 * i + 1].size() != (size_t)l.c_out)
+                continue;
+            conv->set_weights(files[2 * i].data(), files[2 * i + 1].data());
+            shape_ok[i] = 1;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            if (!shape_ok[i])
+            {
+                std::cerr << "ConvModel: weight size mismatch for " << layers_[i].name << std::endl;
+                return false;
+            }
+        }
+
+        // 工作区和带边框的激活缓冲区在构造时并行清零（first-touch）。放在上面的并行循环里会变成
+        // 嵌套并行区而串行执行，页面落在领到该层的那个线程上，所以在顶层逐层进行
+        inputs_.clear();
+        inputs_.resize(n);
+        conv_out_.clear();
+        conv_out_.resize(n);
+        for (int i = 0; i < n; ++i)
+        {
+            const LayerSpec& l = layers_[i];
+            convs_[i]->prepare(heights_[i], widths_[i], num_threads);
+            inputs_[i] = Tensor(1, l.c_in, heights_[i], widths_[i], l.pad);
+            if (l.pool_after)
+                conv_out_[i] = Tensor(1, l.c_out, heights_[i], widths_[i]);
+        }
+        pools_.clear();
+        pools_.resize(n);
+        for (int i = 0; i < n; ++i)
+        {
+            if (!layers_[i].pool_after)
+                continue;
+            pools_[i].reset(new AvgPool2d(2, 2));
+            pools_[i]->set_name(layers_[i].name + "_pool");
+            pools_[i]->prepare(1, layers_[i].c_out, heights_[i], widths_[i], num_threads);
+        }
+        output_ = Tensor(1, layers_[n - 1].c_out, out_h_, out_w_);
+        double t2 = now_ms();
+
+        // 3. 预先触碰没有边框（构造时未清零）的激活缓冲区
+        if (opt.prefault)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                if (layers_[i].pool_after)
+                    prefault(conv_out_[i].view(), num_threads);
+            }
+            prefault(output_.view(), num_threads);
+        }
+        double t3 = now_ms();
+
+        // 4. 合成输入完整前向一次
+        if (opt.warmup)
+        {
+            fill_sin(input());
+            forward();
+        }
+        double t4 = now_ms();
+
+        stats.load_ms = t1 - t0;
+        stats.prepare_ms = t2 - t1;
+        stats.prefault_ms = t3 - t2;
+        stats.warmup_ms = t4 - t3;
+        stats.total_ms = t4 - t0;
+        return true;
+    }
+
+    // 第一层输入（带边框缓冲区的内部区域），调用方直接写入
+    TensorView input() { return inputs_[0].view(); }
+    TensorView output() { return output_.view(); }
+
+    void forward()
+    {
+        const int n = num_layers();
+        for (int i = 0; i < n; ++i)
+        {
+            TensorView next = (i + 1 < n) ? inputs_[i + 1].view() : output_.view();
+            if (layers_[i].pool_after)
+            {
+                convs_[i]->execute_padded(inputs_[i].padded_view(), conv_out_[i].view());
+                pools_[i]->execute(conv_out_[i].view(), next);
+            }
+            else
+            {
+                convs_[i]->execute_padded(inputs_[i].padded_view(), next);
+            }
+        }
+    }
+
+private:
+    std::vector<LayerSpec> layers_;
+    int in_h_;
+    int in_w_;
+    int out_h_;
+    int out_w_;
+    int num_threads_;
+    std::vector<int> heights_;
+    std::vector<int> widths_;
+    std::vector<std::unique_ptr<Conv2d> > convs_;
+    std::vector<std::unique_ptr<AvgPool2d> > pools_;
+    std::vector<Tensor> inputs_;
+    std::vector<Tensor> conv_out_;
+    Tensor output_;
+};
+
+} // namespace ops
+
+#endif // OPERATORS_MODEL_H
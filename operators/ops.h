@@ -0,0 +1,464 @@
+#ifndef OPERATORS_OPS_H
+#define OPERATORS_OPS_H
+
+// 头文件形式的算子库：每个算子对象分为 prepare / execute 两步。
+//   prepare  一次性工作：固定输入形状、拷贝权重、分配并 first-touch 工作区、确定并行配置
+//   execute  请求路径：只读写调用方给出的视图和已分配好的工作区，不做内存分配
+//
+// 用法：
+//   ops::Conv2d conv(ops::Conv2dParams(3, 32, 5, 1, 2));
+//   conv.load_weights("src/conv1.weight.bin", "src/conv1.bias.bin");
+//   conv.prepare(150, 150, num_threads);
+//   conv.execute(input.view(), output.view());
+//
+// 所有 execute 接受带步长的 TensorView：输出可以是拼接结果的一段通道，
+// 输入若已带零边框（Tensor(..., pad)）可用 Conv2d::execute_padded 省去 padding 拷贝。
+// 剪枝后的卷积层按零权重比例自动改用稀疏内核（conv_sparse.h）。
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "tensor.h"
+#include "conv_autotune.h"
+#include "conv_sparse.h"
+#include "stream_store.h"
+#include "profiler.h"
+
+namespace ops {
+
+struct Conv2dParams
+{
+    int c_in;
+    int c_out;
+    int k_h;
+    int k_w;
+    int stride_h;
+    int stride_w;
+    int pad_h;
+    int pad_w;
+
+    Conv2dParams(int in_channels, int out_channels, int kernel, int stride, int padding)
+        : c_in(in_channels), c_out(out_channels), k_h(kernel), k_w(kernel),
+          stride_h(stride), stride_w(stride), pad_h(padding), pad_w(padding) {}
+};
+
+class Conv2d
+{
+public:
+    explicit Conv2d(const Conv2dParams& p)
+        : p_(p), name_("conv2d"), in_h_(0), in_w_(0), prepared_(false), config_(convtune::default_config(1)),
+          weight_((size_t)p.c_out * p.c_in * p.k_h * p.k_w, 0.0f), bias_(p.c_out, 0.0f),
+          sparsity_(0.0), sparse_threshold_(convtune::default_sparse_threshold()), use_sparse_(false) {}
+
+    const Conv2dParams& params() const { return p_; }
+
+    // 剖析记录里的层名，默认 "conv2d"
+    void set_name(const std::string& name) { name_ = name; }
+    const std::string& name() const { return name_; }
+
+    // 权重布局 [c_out][c_in][k_h][k_w]，偏置 [c_out]；拷贝进算子自己的缓冲区，
+    // 同时统计零权重比例并决定本层用稠密还是稀疏内核
+    void set_weights(const float* weight, const float* bias)
+    {
+        std::copy(weight, weight + weight_.size(), weight_.begin());
+        std::copy(bias, bias + bias_.size(), bias_.begin());
+        sparsity_ = convtune::weight_sparsity(weight_.data(), weight_.size());
+        select_kernel();
+    }
+
+    // 零权重比例不低于 threshold 时用稀疏内核；> 1 总是稠密，<= 0 总是稀疏
+    void set_sparse_threshold(double threshold)
+    {
+        sparse_threshold_ = threshold;
+        select_kernel();
+    }
+
+    double sparsity() const { return sparsity_; }
+    bool is_sparse() const { return use_sparse_; }
+
+    bool load_weights(const std::string& weight_path, const std::string& bias_path)
+    {
+        std::vector<float> w, b;
+        if (!read_binary_file(weight_path, w) || !read_binary_file(bias_path, b))
+            return false;
+        if (w.size() != weight_.size() || b.size() != bias_.size())
+        {
+            std::cerr << "Conv2d: weight size mismatch (" << w.size() << " / " << b.size() << ")" << std::endl;
+            return false;
+        }
+        set_weights(w.data(), b.data());
+        return true;
+    }
+
+    int out_h(int in_h) const { return (in_h + 2 * p_.pad_h - p_.k_h) / p_.stride_h + 1; }
+    int out_w(int in_w) const { return (in_w + 2 * p_.pad_w - p_.k_w) / p_.stride_w + 1; }
+
+    // 输入尺寸对应的卷积形状（padding 之后），也是调优缓存的键
+    convtune::ConvShape shape_for(int in_h, int in_w) const
+    {
+        convtune::ConvShape s;
+        s.c_in = p_.c_in;
+        s.in_h = in_h + 2 * p_.pad_h;
+        s.in_w = in_w + 2 * p_.pad_w;
+        s.c_out = p_.c_out;
+        s.k_h = p_.k_h;
+        s.k_w = p_.k_w;
+        s.stride_h = p_.stride_h;
+        s.stride_w = p_.stride_w;
+        s.out_h = out_h(in_h);
+        s.out_w = out_w(in_w);
+        return s;
+    }
+
+    void prepare(int in_h, int in_w, int num_threads)
+    {
+        prepare(in_h, in_w, convtune::default_config(num_threads));
+    }
+
+    // 分配 padding 工作区，边框只在这里清零一次，之后 execute 只覆盖内部区域
+    void prepare(int in_h, int in_w, const convtune::ConvConfig& config)
+    {
+        in_h_ = in_h;
+        in_w_ = in_w;
+        shape_ = shape_for(in_h, in_w);
+        config_ = config;
+        workspace_.resize((size_t)shape_.c_in * shape_.in_h * shape_.in_w);
+
+        // 按 execute 中拷贝的划分方式 first-touch
+        const size_t padded_hw = (size_t)shape_.in_h * shape_.in_w;
+        float* ws = workspace_.data();
+        #pragma omp parallel for num_threads(config_.num_threads)
+        for (int c = 0; c < shape_.c_in; ++c)
+            std::fill(ws + c * padded_hw, ws + (c + 1) * padded_hw, 0.0f);
+        prepared_ = true;
+    }
+
+    const convtune::ConvShape& shape() const { return shape_; }
+    const convtune::ConvConfig& config() const { return config_; }
+    void set_config(const convtune::ConvConfig& config) { config_ = config; }
+
+    // 在已 prepare 的工作区上搜索最优配置并采用；input 用于填充工作区内部
+    convtune::ConvConfig autotune(const TensorView& input, const TensorView& output, int max_threads,
+                                  double& best_ms, bool verbose = true)
+    {
+        copy_interior(input, 0);
+        convtune::ConvShape s = shape_;
+        s.out_row_stride = (int)output.stride_h;
+        s.out_plane_stride = (int)output.stride_c;
+        config_ = convtune::autotune(s, workspace_.data(), weight_.data(), bias_.data(),
+                                     output.plane(0, 0), max_threads, best_ms, 5, verbose);
+        return config_;
+    }
+
+    // 逐样本：拷贝到工作区内部，再执行卷积（偏置在写回时融合）；输入输出可以是带步长的视图
+    bool execute(const TensorView& input, const TensorView& output)
+    {
+        if (!check(input, in_h_, in_w_, output))
+            return false;
+        for (int n = 0; n < input.dim; ++n)
+        {
+            copy_interior(input, n);
+            run(workspace_.data(), shape_, output, n);
+        }
+        return true;
+    }
+
+    // 零拷贝 padding：padded_input 已含 pad 宽的零边框（例如 Tensor(..., pad).padded_view()），
+    // 卷积直接读取它，不经过工作区
+    bool execute_padded(const TensorView& padded_input, const TensorView& output)
+    {
+        if (!check(padded_input, shape_.in_h, shape_.in_w, output))
+            return false;
+        convtune::ConvShape s = shape_;
+        s.in_row_stride = (int)padded_input.stride_h;
+        s.in_plane_stride = (int)padded_input.stride_c;
+        for (int n = 0; n < padded_input.dim; ++n)
+            run(padded_input.plane(n, 0), s, output, n);
+        return true;
+    }
+
+private:
+    bool check(const TensorView& input, int in_h, int in_w, const TensorView& output) const
+    {
+        if (!prepared_ || input.channel != p_.c_in || input.height != in_h || input.width != in_w ||
+            output.channel != p_.c_out || output.height != shape_.out_h || output.width != shape_.out_w ||
+            output.dim != input.dim)
+        {
+            std::cerr << "Conv2d: execute called with a shape that does not match prepare()" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void select_kernel()
+    {
+        use_sparse_ = sparsity_ >= sparse_threshold_;
+        sparse_ = use_sparse_ ? convtune::make_sparse(weight_.data(), p_.c_out, p_.c_in, p_.k_h, p_.k_w)
+                              : convtune::SparseWeights();
+    }
+
+    void run(const float* input, convtune::ConvShape s, const TensorView& output, int n) const
+    {
+        s.out_row_stride = (int)output.stride_h;
+        s.out_plane_stride = (int)output.stride_c;
+        if (use_sparse_)
+        {
+            prof::ScopedOp op(name_, "conv2d_sparse",
+                sparse_.density() * prof::conv2d_flops(s.c_in, s.c_out, s.k_h, s.k_w, s.out_h, s.out_w),
+                prof::conv2d_bytes(s.c_in, s.in_h, s.in_w, s.c_out, s.k_h, s.k_w, s.out_h, s.out_w));
+            convtune::conv2d_sparse(s, input, sparse_, bias_.data(), output.plane(n, 0), config_);
+            return;
+        }
+        prof::ScopedOp op(name_, "conv2d",
+            prof::conv2d_flops(s.c_in, s.c_out, s.k_h, s.k_w, s.out_h, s.out_w),
+            prof::conv2d_bytes(s.c_in, s.in_h, s.in_w, s.c_out, s.k_h, s.k_w, s.out_h, s.out_w));
+        convtune::conv2d_run(s, input, weight_.data(), bias_.data(), output.plane(n, 0), config_);
+    }
+
+    // 并行按通道拷贝样本 n 的每一行到工作区内部
+    void copy_interior(const TensorView& input, int n)
+    {
+        prof::ScopedOp op(name_, "padd", 0.0, 2.0 * input.channel * in_h_ * in_w_ * sizeof(float));
+        const size_t padded_hw = (size_t)shape_.in_h * shape_.in_w;
+        float* ws = workspace_.data();
+        #pragma omp parallel for num_threads(config_.num_threads)
+        for (int c = 0; c < p_.c_in; ++c)
+        {
+            float* dst = ws + c * padded_hw + (size_t)p_.pad_h * shape_.in_w + p_.pad_w;
+            for (int h = 0; h < in_h_; ++h)
+                memcpy(dst + (size_t)h * shape_.in_w, input.row(n, c, h), in_w_ * sizeof(float));
+        }
+    }
+
+    Conv2dParams p_;
+    std::string name_;
+    int in_h_;
+    int in_w_;
+    bool prepared_;
+    convtune::ConvShape shape_;
+    convtune::ConvConfig config_;
+    FloatBuffer weight_;
+    FloatBuffer bias_;
+    FloatBuffer workspace_;
+    double sparsity_;
+    double sparse_threshold_;
+    bool use_sparse_;
+    convtune::SparseWeights sparse_;
+};
+
+// 把 planes 个平面划分为若干行块，使任务数约为线程数的 4 倍。
+// 通道数远多于线程数时每个线程仍分到整个平面，通道较少的层也能扩展。
+inline int avgpool_row_blocks(int planes, int out_h, int num_threads)
+{
+    const int tasks_per_thread = 4;
+    int row_blocks = (tasks_per_thread * num_threads + planes - 1) / planes;
+    if (row_blocks < 1) row_blocks = 1;
+    if (row_blocks > out_h) row_blocks = out_h;
+    return row_blocks;
+}
+
+// 单个平面的输出行 [oh_begin, oh_end)；in_ld / out_ld 为行步长。
+// row_buf 非空时每行先算到 row_buf（至少 out_w 个 float），再整行非临时写出
+inline void avgpool_rows(const float* input_plane, float* output_plane,
+                         int input_h, int input_w, int in_ld, int out_w, int out_ld,
+                         int kernel_h, int kernel_w, int stride_h, int stride_w,
+                         bool use_2x2, int oh_begin, int oh_end, float* row_buf = NULL)
+{
+    if (use_2x2)
+    {
+        // 2x2、步长 2 特化：展开窗口，乘 0.25 代替除法
+        for (int oh = oh_begin; oh < oh_end; ++oh)
+        {
+            float* out_row = row_buf ? row_buf : output_plane + oh * out_ld;
+            for (int ow = 0; ow < out_w; ++ow)
+            {
+                int h_start = oh * 2;
+                int w_start = ow * 2;
+
+                if (h_start + 1 < input_h && w_start + 1 < input_w)
+                {
+                    int idx_00 = h_start * in_ld + w_start;
+                    int idx_10 = idx_00 + in_ld;
+                    float sum = input_plane[idx_00] + input_plane[idx_00 + 1] +
+                                input_plane[idx_10] + input_plane[idx_10 + 1];
+                    out_row[ow] = sum * 0.25f;
+                }
+                else
+                {
+                    // 越界窗口：只平均落在输入内的点
+                    float sum = 0.0f;
+                    int count = 0;
+                    for (int kh = 0; kh < 2; ++kh)
+                    {
+                        for (int kw = 0; kw < 2; ++kw)
+                        {
+                            int h = h_start + kh;
+                            int w = w_start + kw;
+                            if (h < input_h && w < input_w)
+                            {
+                                sum += input_plane[h * in_ld + w];
+                                count++;
+                            }
+                        }
+                    }
+                    out_row[ow] = sum / count;
+                }
+            }
+            if (row_buf)
+                nt::store_row(output_plane + oh * out_ld, row_buf, out_w);
+        }
+    }
+    else
+    {
+        for (int oh = oh_begin; oh < oh_end; ++oh)
+        {
+            float* out_row = row_buf ? row_buf : output_plane + oh * out_ld;
+            for (int ow = 0; ow < out_w; ++ow)
+            {
+                float sum = 0.0f;
+                int count = 0;
+                int h_start = oh * stride_h;
+                int w_start = ow * stride_w;
+                for (int kh = 0; kh < kernel_h; ++kh)
+                {
+                    for (int kw = 0; kw < kernel_w; ++kw)
+                    {
+                        int h = h_start + kh;
+                        int w = w_start + kw;
+                        if (h < input_h && w < input_w)
+                        {
+                            sum += input_plane[h * in_ld + w];
+                            count++;
+                        }
+                    }
+                }
+                out_row[ow] = sum / count;
+            }
+            if (row_buf)
+                nt::store_row(output_plane + oh * out_ld, row_buf, out_w);
+        }
+    }
+}
+
+class AvgPool2d
+{
+public:
+    AvgPool2d(int kernel, int stride)
+        : name_("avgpool"), k_h_(kernel), k_w_(kernel), stride_h_(stride), stride_w_(stride),
+          dim_(0), channel_(0), in_h_(0), in_w_(0), out_h_(0), out_w_(0),
+          num_threads_(1), row_blocks_(1), rows_per_block_(1), prepared_(false) {}
+
+    // 剖析记录里的层名，默认 "avgpool"
+    void set_name(const std::string& name) { name_ = name; }
+    const std::string& name() const { return name_; }
+
+    int out_h() const { return out_h_; }
+    int out_w() const { return out_w_; }
+
+    // 固定输入形状并计算 (平面, 行块) 任务划分
+    void prepare(int dim, int channel, int in_h, int in_w, int num_threads)
+    {
+        dim_ = dim;
+        channel_ = channel;
+        in_h_ = in_h;
+        in_w_ = in_w;
+        out_h_ = (in_h - k_h_) / stride_h_ + 1;
+        out_w_ = (in_w - k_w_) / stride_w_ + 1;
+        num_threads_ = num_threads;
+        row_blocks_ = avgpool_row_blocks(dim * channel, out_h_, num_threads);
+        rows_per_block_ = (out_h_ + row_blocks_ - 1) / row_blocks_;
+        prepared_ = true;
+    }
+
+    // 用与 execute 相同的任务 -> 线程映射 first-touch 输入和输出
+    void first_touch(const TensorView& input, const TensorView& output) const
+    {
+        const int num_tasks = dim_ * channel_ * row_blocks_;
+        #pragma omp parallel for schedule(static) num_threads(num_threads_)
+        for (int t = 0; t < num_tasks; ++t)
+        {
+            int plane = t / row_blocks_;
+            int oh_begin = (t % row_blocks_) * rows_per_block_;
+            int oh_end = std::min(oh_begin + rows_per_block_, out_h_);
+            if (oh_begin >= oh_end)
+                continue;
+
+            // 本任务读取的输入行；最后一个行块同时负责剩余的行
+            int h_begin = std::min(oh_begin * stride_h_, in_h_);
+            int h_end = (oh_end == out_h_) ? in_h_ : std::min(oh_end * stride_h_, in_h_);
+            int n = plane / channel_, c = plane % channel_;
+            for (int h = h_begin; h < h_end; ++h)
+                std::fill(input.row(n, c, h), input.row(n, c, h) + in_w_, 0.0f);
+            for (int oh = oh_begin; oh < oh_end; ++oh)
+                std::fill(output.row(n, c, oh), output.row(n, c, oh) + out_w_, 0.0f);
+        }
+    }
+
+    bool execute(const TensorView& input, const TensorView& output) const
+    {
+        if (!prepared_ || input.dim != dim_ || input.channel != channel_ || input.height != in_h_ ||
+            input.width != in_w_ || output.dim != dim_ || output.channel != channel_ ||
+            output.height != out_h_ || output.width != out_w_)
+        {
+            std::cerr << "AvgPool2d: execute called with a shape that does not match prepare()" << std::endl;
+            return false;
+        }
+        const int planes = dim_ * channel_;
+        const int num_tasks = planes * row_blocks_;
+        const bool use_2x2 = (k_h_ == 2 && k_w_ == 2 && stride_h_ == 2 && stride_w_ == 2);
+        prof::ScopedOp op(name_, "avgpool",
+            prof::avgpool_flops(planes, k_h_, k_w_, out_h_, out_w_),
+            prof::avgpool_bytes(planes, in_h_, in_w_, out_h_, out_w_));
+
+        // 大输出用非临时写，不让一次性写出的结果把输入挤出缓存
+        const bool stream = out_w_ >= 16 && out_w_ <= nt::ROW_BUFFER &&
+                            nt::use_for((size_t)planes * out_h_ * out_w_ * sizeof(float));
+
+        #pragma omp parallel num_threads(num_threads_)
+        {
+            alignas(64) float row_buf[nt::ROW_BUFFER];
+
+            // schedule(static) 保证每次调用的任务 -> 线程映射与 first_touch 相同
+            #pragma omp for schedule(static) nowait
+            for (int t = 0; t < num_tasks; ++t)
+            {
+                int plane = t / row_blocks_;
+                int oh_begin = (t % row_blocks_) * rows_per_block_;
+                int oh_end = std::min(oh_begin + rows_per_block_, out_h_);
+                if (oh_begin >= oh_end)
+                    continue;
+                int n = plane / channel_, c = plane % channel_;
+                avgpool_rows(input.plane(n, c), output.plane(n, c), in_h_, in_w_, (int)input.stride_h,
+                             out_w_, (int)output.stride_h, k_h_, k_w_, stride_h_, stride_w_, use_2x2,
+                             oh_begin, oh_end, stream ? row_buf : NULL);
+            }
+            if (stream)
+                nt::fence();
+        }
+        return true;
+    }
+
+private:
+    std::string name_;
+    int k_h_;
+    int k_w_;
+    int stride_h_;
+    int stride_w_;
+    int dim_;
+    int channel_;
+    int in_h_;
+    int in_w_;
+    int out_h_;
+    int out_w_;
+    int num_threads_;
+    int row_blocks_;
+    int rows_per_block_;
+    bool prepared_;
+};
+
+} // namespace ops
+
+#endif // OPERATORS_OPS_H
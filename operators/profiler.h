@@ -0,0 +1,224 @@
+#ifndef OPERATORS_PROFILER_H
+#define OPERATORS_PROFILER_H
+
+// 逐算子性能剖析：记录每次算子调用的耗时、FLOP 数和访存字节数，
+// 输出 Chrome trace（chrome://tracing / Perfetto 可打开）和 roofline CSV。
+//
+// 始终编译进程序，运行时开关：
+//   OP_PROFILE=1          打开剖析
+//   OP_PROFILE_OUT=<前缀>  输出文件前缀，默认 "profile"
+//                         生成 <前缀>.trace.json 和 <前缀>.roofline.csv
+// 每条记录带层名（Conv2d / AvgPool2d::set_name，ConvModel 取 LayerSpec::name）和算子类型，
+// roofline 按 (层名, 算子类型) 汇总，同类型的不同层分开统计。
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace prof {
+
+struct Record
+{
+    std::string name;  // 层名
+    std::string op;    // 算子类型：conv2d / conv2d_sparse / padd / avgpool
+    double start_us;   // 相对于剖析器创建时刻
+    double dur_us;
+    double flops;
+    double bytes;
+    size_t tid;
+};
+
+class Profiler
+{
+public:
+    static Profiler& instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // 可在运行中由其他线程切换，算子调用方在构造 / 析构 ScopedOp 时各读一次
+    bool enabled() const { return enabled_; }
+    void set_enabled(bool on) { enabled_ = on; }
+
+    double now_us() const
+    {
+        return std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    void record(const std::string& name, const char* op, double start_us, double end_us, double flops, double bytes)
+    {
+        if (!enabled_)
+            return;
+        Record r;
+        r.name = name;
+        r.op = op;
+        r.start_us = start_us;
+        r.dur_us = end_us - start_us;
+        r.flops = flops;
+        r.bytes = bytes;
+        r.tid = std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000;
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.push_back(r);
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.clear();
+    }
+
+    // 写出 Chrome trace JSON，每次调用一个 "X"（complete）事件
+    bool dump_trace(const std::string& path) const
+    {
+        FILE* fp = std::fopen(path.c_str(), "w");
+        if (!fp)
+            return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::fprintf(fp, "{\"traceEvents\":[\n");
+        for (size_t i = 0; i < records_.size(); ++i)
+        {
+            const Record& r = records_[i];
+            double sec = r.dur_us * 1e-6;
+            std::fprintf(fp,
+                "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%zu,"
+                "\"args\":{\"gflops\":%.3f,\"gbytes_per_s\":%.3f,\"flops\":%.0f,\"bytes\":%.0f}}%s\n",
+                r.name.c_str(), r.op.c_str(), r.start_us, r.dur_us, r.tid,
+                sec > 0 ? r.flops / sec * 1e-9 : 0.0, sec > 0 ? r.bytes / sec * 1e-9 : 0.0,
+                r.flops, r.bytes, (i + 1 < records_.size()) ? "," : "");
+        }
+        std::fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+        std::fclose(fp);
+        return true;
+    }
+
+    // 按 (层名, 算子类型) 汇总，写出 roofline 所需的 GFLOP/s、带宽和算术强度
+    bool dump_roofline(const std::string& path) const
+    {
+        FILE* fp = std::fopen(path.c_str(), "w");
+        if (!fp)
+            return false;
+        struct Agg { int calls; double us; double flops; double bytes; };
+        typedef std::pair<std::string, std::string> Key;
+        std::map<Key, Agg> agg;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < records_.size(); ++i)
+            {
+                const Record& r = records_[i];
+                Agg& a = agg[Key(r.name, r.op)];
+                a.calls += 1;
+                a.us += r.dur_us;
+                a.flops += r.flops;
+                a.bytes += r.bytes;
+            }
+        }
+        std::fprintf(fp, "layer,operator,calls,total_ms,mean_ms,gflops,gbytes_per_s,bytes_per_call,flops_per_call,arithmetic_intensity\n");
+        for (std::map<Key, Agg>::const_iterator it = agg.begin(); it != agg.end(); ++it)
+        {
+            const Agg& a = it->second;
+            double sec = a.us * 1e-6;
+            std::fprintf(fp, "%s,%s,%d,%.4f,%.4f,%.3f,%.3f,%.0f,%.0f,%.4f\n",
+                it->first.first.c_str(), it->first.second.c_str(), a.calls, a.us * 1e-3, a.us * 1e-3 / a.calls,
+                sec > 0 ? a.flops / sec * 1e-9 : 0.0, sec > 0 ? a.bytes / sec * 1e-9 : 0.0,
+                a.bytes / a.calls, a.flops / a.calls,
+                a.bytes > 0 ? a.flops / a.bytes : 0.0);
+        }
+        std::fclose(fp);
+        return true;
+    }
+
+    // 程序结束时调用：打开剖析时写出两个文件
+    void dump() const
+    {
+        if (!enabled_)
+            return;
+        std::string trace = prefix_ + ".trace.json";
+        std::string roofline = prefix_ + ".roofline.csv";
+        if (dump_trace(trace) && dump_roofline(roofline))
+            std::fprintf(stderr, "Profile written to %s, %s\n", trace.c_str(), roofline.c_str());
+        else
+            std::fprintf(stderr, "Failed to write profile %s\n", prefix_.c_str());
+    }
+
+private:
+    Profiler() : enabled_(false), prefix_("profile"), origin_(std::chrono::steady_clock::now())
+    {
+        const char* on = std::getenv("OP_PROFILE");
+        enabled_ = on && on[0] != '\0' && on[0] != '0';
+        const char* out = std::getenv("OP_PROFILE_OUT");
+        if (out && out[0] != '\0')
+            prefix_ = out;
+    }
+
+    std::atomic<bool> enabled_;
+    std::string prefix_;
+    std::chrono::steady_clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<Record> records_;
+};
+
+// RAII 计时区间：构造时开始，析构时记录。name 引用算子自己的层名，须比本对象活得久。
+// 只有构造时剖析已打开才记录，中途打开不会记下从 0 开始的区间
+class ScopedOp
+{
+public:
+    ScopedOp(const std::string& name, const char* op, double flops, double bytes)
+        : name_(name), op_(op), flops_(flops), bytes_(bytes), started_(false), start_(0.0)
+    {
+        if (Profiler::instance().enabled())
+        {
+            started_ = true;
+            start_ = Profiler::instance().now_us();
+        }
+    }
+
+    ~ScopedOp()
+    {
+        Profiler& p = Profiler::instance();
+        if (started_)
+            p.record(name_, op_, start_, p.now_us(), flops_, bytes_);
+    }
+
+private:
+    const std::string& name_;
+    const char* op_;
+    double flops_;
+    double bytes_;
+    bool started_;
+    double start_;
+};
+
+// 常用算子的理论计算量 / 最小访存量（float32）
+inline double conv2d_flops(int c_in, int c_out, int k_h, int k_w, int out_h, int out_w)
+{
+    return 2.0 * c_in * c_out * k_h * k_w * out_h * out_w;
+}
+
+inline double conv2d_bytes(int c_in, int in_h, int in_w, int c_out, int k_h, int k_w, int out_h, int out_w)
+{
+    double elems = (double)c_in * in_h * in_w + (double)c_out * c_in * k_h * k_w + c_out + (double)c_out * out_h * out_w;
+    return elems * sizeof(float);
+}
+
+inline double avgpool_flops(int planes, int k_h, int k_w, int out_h, int out_w)
+{
+    // k_h*k_w-1 次加法 + 1 次乘法
+    return (double)planes * out_h * out_w * k_h * k_w;
+}
+
+inline double avgpool_bytes(int planes, int in_h, int in_w, int out_h, int out_w)
+{
+    return ((double)planes * in_h * in_w + (double)planes * out_h * out_w) * sizeof(float);
+}
+
+} // namespace prof
+
+#endif // OPERATORS_PROFILER_H
@@ -0,0 +1,95 @@
+#ifndef OPERATORS_STREAM_STORE_H
+#define OPERATORS_STREAM_STORE_H
+
+// 大输出的非临时写（streaming store）。
+// 卷积 / 池化的输出只写一次，同一个核心短时间内不会再读；普通写会先把目标行读入缓存（RFO），
+// 再把输入工作集挤出去。非临时写经写合并缓冲区直接写回内存，不占缓存。
+//
+// 用法：内核先把一行结果算到栈上的小缓冲区，再用 store_row 整行写出；
+// 每个线程在并行区结束（屏障）之前调用 fence()，保证其他线程随后能读到结果。
+//
+// 只有输出总量不小于阈值时才启用：默认为末级缓存的一半（输出本身就会挤掉大半个缓存），
+// 环境变量 OPS_STREAM_MIN_BYTES 可改（0 总是启用，很大的值即关闭）。
+// 放得进缓存的输出很快会被下一层读取，留在缓存里更好，非临时写反而更慢。
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define NT_STORE_X86 1
+#endif
+
+namespace nt {
+
+// 内核栈上行缓冲区的大小（float 个数），一行超过它时退回普通写
+const int ROW_BUFFER = 2048;
+
+// 末级缓存大小；查询不到时按 32 MiB 估计
+inline size_t llc_bytes()
+{
+    long bytes = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (bytes <= 0)
+        bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    return bytes > 0 ? (size_t)bytes : (size_t)32 << 20;
+}
+
+inline size_t threshold_bytes()
+{
+    static const size_t threshold = []() {
+        const char* env = std::getenv("OPS_STREAM_MIN_BYTES");
+        return env ? (size_t)std::strtoull(env, NULL, 10) : llc_bytes() / 2;
+    }();
+    return threshold;
+}
+
+inline bool use_for(size_t output_bytes)
+{
+    return output_bytes >= threshold_bytes();
+}
+
+// 把 n 个 float 从 src 非临时地写到 dst；dst 不要求对齐，首尾不足一个向量的部分用普通写
+inline void store_row(float* dst, const float* src, int n)
+{
+#if defined(NT_STORE_X86)
+#if defined(__AVX__)
+    const size_t align = 32;
+#else
+    const size_t align = 16;
+#endif
+    int i = 0;
+    while (i < n && ((size_t)(dst + i) & (align - 1)) != 0)
+    {
+        dst[i] = src[i];
+        ++i;
+    }
+#if defined(__AVX__)
+    for (; i + 8 <= n; i += 8)
+        _mm256_stream_ps(dst + i, _mm256_loadu_ps(src + i));
+#endif
+    for (; i + 4 <= n; i += 4)
+        _mm_stream_ps(dst + i, _mm_loadu_ps(src + i));
+    for (; i < n; ++i)
+        dst[i] = src[i];
+#else
+    memcpy(dst, src, n * sizeof(float));
+#endif
+}
+
+inline void fence()
+{
+#if defined(NT_STORE_X86)
+    _mm_sfence();
+#endif
+}
+
+} // namespace nt
+
+#endif // OPERATORS_STREAM_STORE_H
@@ -0,0 +1,247 @@
+#ifndef OPERATORS_TENSOR_H
+#define OPERATORS_TENSOR_H
+
+// 算子库的张量类型和公共工具：
+//   Tensor      拥有存储的 NCHW float 张量（原各程序中的 Mat）
+//   TensorView  不拥有存储的带步长 NCHW 视图，算子的 execute 接口只接受视图
+// 以及原来在每个程序中重复定义的 readBinaryFile / pretensor / get_current_time。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/numa.h"
+
+namespace ops {
+
+// resize() 时不初始化新元素：页面不会被主线程提前访问，由算子的 prepare
+// 按执行时相同的线程划分 first-touch，多路服务器上每个线程的数据在本地节点
+template <typename T>
+struct default_init_allocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind { typedef default_init_allocator<U> other; };
+
+    default_init_allocator() = default;
+    template <typename U>
+    default_init_allocator(const default_init_allocator<U>&) {}
+
+    template <typename U>
+    void construct(U* ptr) { ::new (static_cast<void*>(ptr)) U; }
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) { ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...); }
+};
+
+typedef std::vector<float, default_init_allocator<float> > FloatBuffer;
+
+// 不拥有存储的 NCHW 视图：形状 + 步长 + 指针。
+// 同一行内的元素总是连续的（w 方向步长为 1，内核沿 w 向量化），
+// n / c / h 三个方向的步长任意，因此切片、裁剪、padding 内部区域和拼接目标都可以零拷贝表示。
+struct TensorView
+{
+    float* data;
+    int dim;
+    int channel;
+    int height;
+    int width;
+    size_t stride_n;
+    size_t stride_c;
+    size_t stride_h;
+
+    TensorView() : data(NULL), dim(0), channel(0), height(0), width(0), stride_n(0), stride_c(0), stride_h(0) {}
+
+    // 连续存放
+    TensorView(float* p, int d, int c, int h, int w)
+        : data(p), dim(d), channel(c), height(h), width(w),
+          stride_n((size_t)c * h * w), stride_c((size_t)h * w), stride_h(w) {}
+
+    TensorView(float* p, int d, int c, int h, int w, size_t sn, size_t sc, size_t sh)
+        : data(p), dim(d), channel(c), height(h), width(w), stride_n(sn), stride_c(sc), stride_h(sh) {}
+
+    size_t size() const { return (size_t)dim * channel * height * width; }
+
+    bool is_contiguous() const
+    {
+        return stride_h == (size_t)width && stride_c == (size_t)height * width &&
+               (dim <= 1 || stride_n == (size_t)channel * height * width);
+    }
+
+    float* plane(int n, int c) const { return data + n * stride_n + c * stride_c; }
+    float* row(int n, int c, int h) const { return plane(n, c) + h * stride_h; }
+    float& at(int n, int c, int h, int w) const { return row(n, c, h)[w]; }
+
+    // 样本 [n_begin, n_end)
+    TensorView slice_batch(int n_begin, int n_end) const
+    {
+        return TensorView(data + n_begin * stride_n, n_end - n_begin, channel, height, width,
+                          stride_n, stride_c, stride_h);
+    }
+
+    // 通道 [c_begin, c_end)
+    TensorView slice_channels(int c_begin, int c_end) const
+    {
+        return TensorView(data + c_begin * stride_c, dim, c_end - c_begin, height, width,
+                          stride_n, stride_c, stride_h);
+    }
+
+    // 空间裁剪：从 (h0, w0) 开始的 h x w 区域
+    TensorView crop(int h0, int w0, int h, int w) const
+    {
+        return TensorView(data + h0 * stride_h + w0, dim, channel, h, w, stride_n, stride_c, stride_h);
+    }
+
+    // crop 的逆操作：四周各扩展 pad_h / pad_w，调用方保证底层存储有这么大的边框
+    TensorView expand(int pad_h, int pad_w) const
+    {
+        return TensorView(data - pad_h * stride_h - pad_w, dim, channel, height + 2 * pad_h, width + 2 * pad_w,
+                          stride_n, stride_c, stride_h);
+    }
+};
+
+// 拥有存储的 NCHW 张量，元素初始不清零。
+// pad > 0 时每个平面四周预留 pad 宽的零边框：view() 是内部区域，padded_view() 含边框，
+// 上游算子直接写入 view()，卷积用 padded_view() 读取，省去 padding 拷贝。
+struct Tensor
+{
+    FloatBuffer tensor;
+
+    int dim;
+    int channel;
+    int height;
+    int width;
+    int pad;
+
+    Tensor() : dim(0), channel(0), height(0), width(0), pad(0) {}
+
+    // 边框需要清零时按平面并行清零，同时完成 first-touch
+    Tensor(int d, int c, int h, int w, int p = 0) : dim(d), channel(c), height(h), width(w), pad(p) {
+        tensor.resize((size_t)d * c * (h + 2 * p) * (w + 2 * p));
+        if (p > 0)
+        {
+            const size_t plane = (size_t)(h + 2 * p) * (w + 2 * p);
+            float* base = tensor.data();
+            #pragma omp parallel for
+            for (int i = 0; i < d * c; ++i)
+                std::fill(base + i * plane, base + (i + 1) * plane, 0.0f);
+        }
+    }
+
+    float& operator[](size_t index) { return tensor[index]; }
+    const float& operator[](size_t index) const { return tensor[index]; }
+
+    size_t size() const { return tensor.size(); }
+
+    TensorView padded_view()
+    {
+        return TensorView(tensor.data(), dim, channel, height + 2 * pad, width + 2 * pad);
+    }
+
+    TensorView view() { return padded_view().crop(pad, pad, height, width); }
+
+    // 显式 NUMA 放置（交错或绑定到某节点），已访问过的页面也会迁移；默认不调用即为 first-touch
+    bool place(numa::Policy policy, int node = 0)
+    {
+        return numa::place(tensor.data(), tensor.size() * sizeof(float), policy, node);
+    }
+};
+
+// 通道拼接的零拷贝写法：把拼接结果 dst 按通道切成若干视图，各分支直接写入自己的那一段
+inline std::vector<TensorView> concat_views(const TensorView& dst, const std::vector<int>& channels)
+{
+    std::vector<TensorView> parts;
+    int c = 0;
+    for (size_t i = 0; i < channels.size(); ++i)
+    {
+        parts.push_back(dst.slice_channels(c, c + channels[i]));
+        c += channels[i];
+    }
+    return parts;
+}
+
+// 按样本切分成若干份（例如多实例服务把一个 batch 分给各实例），不拷贝
+inline std::vector<TensorView> split_batch(const TensorView& t, int parts)
+{
+    std::vector<TensorView> views;
+    for (int i = 0; i < parts; ++i)
+    {
+        int n_begin = (int)((long long)t.dim * i / parts);
+        int n_end = (int)((long long)t.dim * (i + 1) / parts);
+        if (n_end > n_begin)
+            views.push_back(t.slice_batch(n_begin, n_end));
+    }
+    return views;
+}
+
+// 预先触碰视图覆盖的全部页面（写零），按平面并行，避免第一次推理时才缺页
+inline void prefault(const TensorView& t, int num_threads)
+{
+    const int planes = t.dim * t.channel;
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < planes; ++i)
+    {
+        for (int h = 0; h < t.height; ++h)
+        {
+            float* row = t.row(i / t.channel, i % t.channel, h);
+            std::fill(row, row + t.width, 0.0f);
+        }
+    }
+}
+
+inline bool read_binary_file(const std::string& filepath, std::vector<float>& buffer)
+{
+    std::ifstream file(filepath.c_str(), std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open file: " << filepath << std::endl;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    buffer.resize(size / sizeof(float));
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), size))
+    {
+        std::cerr << "Failed to read file: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 测试输入：sin(逻辑线性下标)，与原 pretensor 一致，与视图的步长无关。
+// 按平面静态划分并行填充，不再由主线程 first-touch 整个张量
+inline void fill_sin(const TensorView& t)
+{
+    const int planes = t.dim * t.channel;
+    const size_t plane_size = (size_t)t.height * t.width;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < planes; ++i)
+    {
+        size_t index = i * plane_size;
+        for (int h = 0; h < t.height; ++h)
+        {
+            float* row = t.row(i / t.channel, i % t.channel, h);
+            for (int w = 0; w < t.width; ++w)
+                row[w] = std::sin(static_cast<float>(index++));
+        }
+    }
+}
+
+// 毫秒时间戳
+inline double now_ms()
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
+    return usec.count() / 1000.0;
+}
+
+} // namespace ops
+
+#endif // OPERATORS_TENSOR_H
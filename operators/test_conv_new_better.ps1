@@ -1,5 +1,10 @@
 # 批量测试不同线程数的conv_openmp_optimized程序（优化版本）
-# 使用方法: .\test_conv_memory.ps1
+# 使用方法: .\test_conv_memory.ps1 [-Tune]
+#   -Tune: 先运行自动调优，把最优循环顺序/分块写入 conv_tuning.cache，后续测试读取该缓存
+
+param(
+    [switch]$Tune
+)
 
 # 切换到脚本所在目录
 $scriptPath = Split-Path -Parent $MyInvocation.MyCommand.Path
@@ -25,6 +30,12 @@ if ($LASTEXITCODE -ne 0) {
 Write-Host "Compilation successful!" -ForegroundColor Green
 Write-Host ""
 
+if ($Tune) {
+    Write-Host "Autotuning conv tiling / loop order / threads..." -ForegroundColor Yellow
+    .\conv_openmp_optimized.exe --tune | Select-String -Pattern "Conv config|Tuning cache" | ForEach-Object { Write-Host $_ -ForegroundColor White }
+    Write-Host ""
+}
+
 # 创建结果文件
 $resultFile = "conv_openmp_optimized_results.txt"
 $timestamp = Get-Date -Format "yyyy-MM-dd HH:mm:ss"
@@ -0,0 +1,415 @@
+// 卷积各版本的正确性 + 性能回归测试。
+//
+// 正确性：在随机形状（固定种子，可复现）上运行每个版本，与串行版本 conv.cpp 比较最大绝对误差。
+//         稀疏版本的权重先按幅值剪枝，与串行版本在同一组剪枝后的权重上的结果比较。
+// 性能：在 conv1 形状（3x150x150 -> 32, 5x5, padding 2）上测每个版本的中位数时间，
+//       写入 JSON 基线；给出已有基线时，任一版本比基线慢超过阈值即失败。
+//       算子库版本只计 execute：构造、set_weights、prepare 和输入拷贝在计时之外做一次。
+//
+// 用法: test_conv_regression [选项]
+//   --threads N            线程数（默认 omp_get_max_threads()）
+//   --shapes N             随机形状个数（默认 8）
+//   --seed S               随机种子（默认 2024）
+//   --no-perf              只做正确性检查
+//   --baseline FILE        与基线比较；文件不存在时写入当前结果作为基线
+//   --update-baseline      总是用当前结果覆盖基线
+//   --threshold T          允许的相对回归（默认 0.2，即慢 20% 以内通过）
+//   --repeats R            每个版本的计时次数（默认 7，取中位数）
+//
+// conv.cpp / conv_openmp.cpp 是独立程序，这里把它们整体包含进各自的命名空间直接调用其 conv2d，
+// 测的就是仓库里的原始代码；标准头文件先在全局包含，命名空间内的重复包含被头文件保护跳过。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <time.h>
+#include <vector>
+#include <omp.h>
+#include "ops.h"
+
+#define main conv_serial_main
+namespace serial {
+#include "conv.cpp"
+}
+#undef main
+
+#define main conv_openmp_main
+namespace openmp {
+#include "conv_openmp.cpp"
+}
+#undef main
+
+struct TestShape
+{
+    int c_in;
+    int c_out;
+    int h;
+    int w;
+    int k;
+
+    std::string str() const
+    {
+        std::ostringstream os;
+        os << c_in << "x" << h << "x" << w << " -> " << c_out << " k" << k;
+        return os.str();
+    }
+};
+
+// 一个被测版本：输入 [c_in][h][w]，输出 [c_out][h][w]（stride 1，same padding）
+struct Variant
+{
+    std::string name;
+    // 独立程序版本（serial / openmp）：每次调用完整运行一次；为 NULL 时是算子库版本
+    void (*run)(const TestShape&, const std::vector<float>& in, const std::vector<float>& weight,
+                const std::vector<float>& bias, std::vector<float>& out, int threads);
+    // 算子库版本：分块配置、是否零拷贝（带边框输入）、是否强制稀疏内核
+    convtune::ConvConfig (*config)(int threads);
+    bool padded;
+    bool sparse;
+    bool pruned;  // 使用按 SPARSE_PRUNE 剪枝后的权重
+};
+
+template <typename MatT>
+void to_mat(const std::vector<float>& src, MatT& mat)
+{
+    std::copy(src.begin(), src.end(), mat.tensor.begin());
+}
+
+void run_serial(const TestShape& s, const std::vector<float>& in, const std::vector<float>& weight,
+                const std::vector<float>& bias, std::vector<float>& out, int)
+{
+    // 串行版本读取全局的 padding / kernel / stride 配置
+    serial::padding = s.k / 2;
+    serial::conv_kernel_size.assign(2, s.k);
+    serial::conv_stride.assign(2, 1);
+    serial::Mat input(1, s.c_in, s.h, s.w), output(1, s.c_out, s.h, s.w);
+    to_mat(in, input);
+    std::fill(output.tensor.begin(), output.tensor.end(), 0.0f);
+    serial::conv2d(input, output, weight, bias, serial::conv_kernel_size, serial::conv_stride, serial::padding);
+    out.assign(output.tensor.begin(), output.tensor.end());
+}
+
+void run_openmp(const TestShape& s, const std::vector<float>& in, const std::vector<float>& weight,
+                const std::vector<float>& bias, std::vector<float>& out, int)
+{
+    std::vector<int> kernel(2, s.k), stride(2, 1);
+    openmp::Mat input(1, s.c_in, s.h, s.w), output(1, s.c_out, s.h, s.w);
+    to_mat(in, input);
+    std::fill(output.tensor.begin(), output.tensor.end(), 0.0f);
+    openmp::conv2d(input, output, weight, bias, kernel, stride, s.k / 2);
+    out.assign(output.tensor.begin(), output.tensor.end());
+}
+
+// 算子库版本：构造时完成 set_weights、prepare 和输入拷贝，execute 只做卷积
+class LibraryConv
+{
+public:
+    LibraryConv(const TestShape& s, const std::vector<float>& in, const std::vector<float>& weight,
+                const std::vector<float>& bias, const convtune::ConvConfig& cfg, bool padded, bool sparse)
+        : conv_(ops::Conv2dParams(s.c_in, s.c_out, s.k, 1, s.k / 2)), padded_(padded)
+    {
+        if (sparse)
+            conv_.set_sparse_threshold(0.0);
+        conv_.set_weights(weight.data(), bias.data());
+        conv_.prepare(s.h, s.w, cfg);
+        input_ = ops::Tensor(1, s.c_in, s.h, s.w, padded ? s.k / 2 : 0);
+        output_ = ops::Tensor(1, s.c_out, conv_.out_h(s.h), conv_.out_w(s.w));
+        ops::TensorView iv = input_.view();
+        size_t idx = 0;
+        for (int c = 0; c < s.c_in; ++c)
+            for (int h = 0; h < s.h; ++h)
+                for (int w = 0; w < s.w; ++w)
+                    iv.at(0, c, h, w) = in[idx++];
+    }
+
+    void execute()
+    {
+        if (padded_)
+            conv_.execute_padded(input_.padded_view(), output_.view());
+        else
+            conv_.execute(input_.view(), output_.view());
+    }
+
+    void result(std::vector<float>& out) const
+    {
+        out.assign(output_.tensor.begin(), output_.tensor.end());
+    }
+
+private:
+    ops::Conv2d conv_;
+    ops::Tensor input_;
+    ops::Tensor output_;
+    bool padded_;
+};
+
+void run_variant(const Variant& v, const TestShape& s, const std::vector<float>& in,
+                 const std::vector<float>& weight, const std::vector<float>& bias, std::vector<float>& out,
+                 int threads)
+{
+    if (v.run)
+    {
+        v.run(s, in, weight, bias, out, threads);
+        return;
+    }
+    LibraryConv conv(s, in, weight, bias, v.config(threads), v.padded, v.sparse);
+    conv.execute();
+    conv.result(out);
+}
+
+convtune::ConvConfig spatial_config(int threads)
+{
+    return convtune::default_config(threads);
+}
+
+convtune::ConvConfig channel_config(int threads)
+{
+    convtune::ConvConfig cfg;
+    cfg.loop_order = convtune::LOOP_CHANNEL;
+    cfg.tile_oc = 4;
+    cfg.tile_oh = 4;
+    cfg.tile_ow = 64;
+    cfg.num_threads = threads;
+    return cfg;
+}
+
+// 稀疏版本（强制使用稀疏内核，CSR 中只有非零抽头）的剪枝比例，处在稀疏内核的目标区间（50%~90%）内
+const double SPARSE_PRUNE = 0.7;
+
+void random_problem(const TestShape& s, std::mt19937& rng, std::vector<float>& in,
+                    std::vector<float>& weight, std::vector<float>& bias)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    in.resize((size_t)s.c_in * s.h * s.w);
+    weight.resize((size_t)s.c_out * s.c_in * s.k * s.k);
+    bias.resize(s.c_out);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = dist(rng);
+    for (size_t i = 0; i < weight.size(); ++i) weight[i] = dist(rng);
+    for (size_t i = 0; i < bias.size(); ++i) bias[i] = dist(rng);
+}
+
+double max_abs_error(const std::vector<float>& a, const std::vector<float>& b)
+{
+    if (a.size() != b.size())
+        return 1e300;
+    double err = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        err = std::max(err, (double)std::fabs(a[i] - b[i]));
+    return err;
+}
+
+double max_abs(const std::vector<float>& a)
+{
+    double m = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        m = std::max(m, (double)std::fabs(a[i]));
+    return m;
+}
+
+// 只读取 "timings_ms" 对象中的 "名字": 数值 对
+bool load_baseline(const std::string& path, std::map<std::string, double>& timings)
+{
+    std::ifstream in(path.c_str());
+    if (!in.is_open())
+        return false;
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string text = ss.str();
+    size_t pos = text.find("\"timings_ms\"");
+    if (pos == std::string::npos)
+        return false;
+    pos = text.find('{', pos);
+    size_t end = text.find('}', pos);
+    while (pos != std::string::npos && pos < end)
+    {
+        size_t q1 = text.find('"', pos);
+        if (q1 == std::string::npos || q1 > end)
+            break;
+        size_t q2 = text.find('"', q1 + 1);
+        size_t colon = text.find(':', q2);
+        timings[text.substr(q1 + 1, q2 - q1 - 1)] = std::atof(text.c_str() + colon + 1);
+        pos = text.find(',', colon);
+    }
+    return !timings.empty();
+}
+
+bool save_baseline(const std::string& path, const std::vector<Variant>& variants,
+                   const std::map<std::string, double>& timings, int threads)
+{
+    std::ofstream out(path.c_str());
+    if (!out.is_open())
+    {
+        std::cerr << "Failed to write baseline: " << path << std::endl;
+        return false;
+    }
+    out << "{\n  \"shape\": \"3x150x150 -> 32 k5\",\n  \"threads\": " << threads << ",\n  \"timings_ms\": {\n";
+    for (size_t i = 0; i < variants.size(); ++i)
+    {
+        out << "    \"" << variants[i].name << "\": " << timings.find(variants[i].name)->second
+            << (i + 1 < variants.size() ? ",\n" : "\n");
+    }
+    out << "  }\n}\n";
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    int threads = omp_get_max_threads();
+    int num_shapes = 8;
+    unsigned seed = 2024;
+    bool perf = true;
+    bool update_baseline = false;
+    std::string baseline_path;
+    double threshold = 0.2;
+    int repeats = 7;
+    for (int a = 1; a < argc; ++a)
+    {
+        std::string arg = argv[a];
+        if (arg == "--threads" && a + 1 < argc) threads = std::max(1, std::atoi(argv[++a]));
+        else if (arg == "--shapes" && a + 1 < argc) num_shapes = std::max(0, std::atoi(argv[++a]));
+        else if (arg == "--seed" && a + 1 < argc) seed = (unsigned)std::strtoul(argv[++a], NULL, 10);
+        else if (arg == "--no-perf") perf = false;
+        else if (arg == "--baseline" && a + 1 < argc) baseline_path = argv[++a];
+        else if (arg == "--update-baseline") update_baseline = true;
+        else if (arg == "--threshold" && a + 1 < argc) threshold = std::atof(argv[++a]);
+        else if (arg == "--repeats" && a + 1 < argc) repeats = std::max(1, std::atoi(argv[++a]));
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 2;
+        }
+    }
+    omp_set_num_threads(threads);
+
+    std::vector<Variant> variants;
+    Variant v;
+    v.config = NULL;
+    v.padded = false;
+    v.sparse = false;
+    v.pruned = false;
+    v.name = "serial";         v.run = run_serial;  variants.push_back(v);
+    v.name = "openmp";         v.run = run_openmp;  variants.push_back(v);
+    v.run = NULL;
+    v.name = "lib_spatial";    v.config = spatial_config;  variants.push_back(v);
+    v.name = "lib_channel";    v.config = channel_config;  variants.push_back(v);
+    v.name = "lib_zero_copy";  v.config = channel_config;  v.padded = true;  variants.push_back(v);
+    // 沿用 lib_zero_copy 的配置，强制稀疏内核并使用剪枝后的权重
+    v.name = "lib_sparse";     v.sparse = true;  v.pruned = true;  variants.push_back(v);
+
+    // 随机形状：原始版本只支持 3x3 / 5x5、stride 1、same padding，串行版本最多 100 个输入通道
+    std::mt19937 rng(seed);
+    std::vector<TestShape> shapes;
+    TestShape conv1 = { 3, 32, 150, 150, 5 };
+    shapes.push_back(conv1);
+    for (int i = 0; i < num_shapes; ++i)
+    {
+        TestShape s;
+        s.c_in = 1 + (int)(rng() % 8);
+        s.c_out = 1 + (int)(rng() % 24);
+        s.h = 5 + (int)(rng() % 60);
+        s.w = 5 + (int)(rng() % 60);
+        s.k = (rng() % 2) ? 5 : 3;
+        shapes.push_back(s);
+    }
+
+    int failures = 0;
+    std::cout << "Correctness (max abs error vs serial, " << threads << " threads, seed " << seed << ")" << std::endl;
+    for (size_t i = 0; i < shapes.size(); ++i)
+    {
+        const TestShape& s = shapes[i];
+        std::vector<float> in, weight, bias, ref, out;
+        random_problem(s, rng, in, weight, bias);
+        run_variant(variants[0], s, in, weight, bias, ref, threads);
+        // float 累加顺序不同，容差按输出量级和累加长度放宽
+        double tol = 1e-6 * s.c_in * s.k * s.k * std::max(1.0, max_abs(ref));
+        std::cout << "  " << s.str() << ":";
+        // 剪枝后的权重和串行版本在其上的参考结果
+        std::vector<float> pruned_weight = weight, pruned_ref;
+        convtune::prune_magnitude(pruned_weight, SPARSE_PRUNE);
+        run_variant(variants[0], s, in, pruned_weight, bias, pruned_ref, threads);
+        for (size_t k = 1; k < variants.size(); ++k)
+        {
+            bool pruned = variants[k].pruned;
+            run_variant(variants[k], s, in, pruned ? pruned_weight : weight, bias, out, threads);
+            double err = max_abs_error(pruned ? pruned_ref : ref, out);
+            bool ok = err <= tol;
+            std::cout << " " << variants[k].name << "=" << err << (ok ? "" : " FAIL");
+            if (!ok)
+                ++failures;
+        }
+        std::cout << std::endl;
+    }
+
+    if (perf)
+    {
+        std::vector<float> in, weight, bias, out;
+        random_problem(conv1, rng, in, weight, bias);
+        std::map<std::string, double> timings;
+        std::cout << "Performance (" << conv1.str() << ", median of " << repeats << ")" << std::endl;
+        for (size_t k = 0; k < variants.size(); ++k)
+        {
+            std::vector<float> w = weight;
+            if (variants[k].pruned)
+                convtune::prune_magnitude(w, SPARSE_PRUNE);
+            const Variant& var = variants[k];
+            // 算子库版本在计时之外准备一次，计时只包含 execute
+            std::unique_ptr<LibraryConv> lib;
+            if (!var.run)
+                lib.reset(new LibraryConv(conv1, in, w, bias, var.config(threads), var.padded, var.sparse));
+            std::vector<double> times(repeats);
+            for (int r = -1; r < repeats; ++r)  // r = -1 为预热
+            {
+                double t0 = omp_get_wtime();
+                if (lib)
+                    lib->execute();
+                else
+                    var.run(conv1, in, w, bias, out, threads);
+                if (r >= 0)
+                    times[r] = (omp_get_wtime() - t0) * 1000.0;
+            }
+            std::sort(times.begin(), times.end());
+            timings[variants[k].name] = times[repeats / 2];
+        }
+
+        std::map<std::string, double> baseline;
+        bool have_baseline = !baseline_path.empty() && !update_baseline && load_baseline(baseline_path, baseline);
+        for (size_t k = 0; k < variants.size(); ++k)
+        {
+            const std::string& name = variants[k].name;
+            double t = timings[name];
+            std::printf("  %-14s %10.3f ms", name.c_str(), t);
+            if (have_baseline && baseline.count(name))
+            {
+                double ratio = t / baseline[name];
+                bool ok = ratio <= 1.0 + threshold;
+                std::printf("  baseline %10.3f ms  %+6.1f%%%s", baseline[name], (ratio - 1.0) * 100.0,
+                            ok ? "" : "  REGRESSION");
+                if (!ok)
+                    ++failures;
+            }
+            std::printf("\n");
+        }
+        if (!baseline_path.empty() && !have_baseline)
+        {
+            if (save_baseline(baseline_path, variants, timings, threads))
+                std::cout << "Baseline written to " << baseline_path << std::endl;
+        }
+    }
+
+    if (failures > 0)
+    {
+        std::cout << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
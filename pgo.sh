@@ -0,0 +1,113 @@
+#!/usr/bin/env bash
+# PGO 流水线：基线构建 -> 插桩构建 -> 按 test_all.ps1 的规模扫描训练 -> 用 profile 重新构建，
+# 然后在同样的规模上对比基线和 PGO 版本，逐个内核报告加速比。
+#
+# 用法: ./pgo.sh [额外的 cmake 参数...]
+#   FLAVOR=avx2 ./pgo.sh                      选择 ISA flavor（默认 generic）
+#   PGO_SIZES_2D="256 1024" PGO_SIZES_3D="64" ./pgo.sh
+#   PGO_THREADS=8 PGO_REPEAT=5 ./pgo.sh -DITER_LTO=ON
+#
+# 训练和 USE 构建必须在同一个构建目录中完成：GCC 按目标文件路径命名 .gcda 文件。
+# 结果写到 $PGO_BUILD_DIR/pgo_report.csv。
+
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")" && pwd)"
+FLAVOR="${FLAVOR:-generic}"
+OUT="${PGO_BUILD_DIR:-$ROOT/build-pgo}"
+THREADS="${PGO_THREADS:-$(nproc)}"
+SIZES_2D="${PGO_SIZES_2D:-64 128 256 512 1024 2048}"
+SIZES_3D="${PGO_SIZES_3D:-64 128 256 512}"
+TRAIN_THREADS="${PGO_TRAIN_THREADS:-1 $THREADS}"
+REPEAT="${PGO_REPEAT:-3}"
+PROFILE_DIR="$OUT/profiles"
+RUN_DIR="$OUT/run"
+JOBS="$(nproc)"
+
+TARGETS="test_aligned_2d_$FLAVOR test_aligned_3d_$FLAVOR conv_openmp_optimized_$FLAVOR avgpool_openmp_memory_$FLAVOR"
+
+build() {
+    local dir="$1"; shift
+    cmake -S "$ROOT" -B "$dir" -DCMAKE_BUILD_TYPE=Release -DITER_FLAVORS="$FLAVOR" "$@" > "$dir.configure.log"
+    # shellcheck disable=SC2086
+    cmake --build "$dir" -j"$JOBS" --target $TARGETS > "$dir.build.log"
+}
+
+# 运行求解器驱动，输出 "内核,时间(ms)" 行
+run_gs() {
+    local bin="$1" dim="$2" n="$3" t="$4"
+    (cd "$RUN_DIR" && "$bin/test_aligned_${dim}_$FLAVOR" "$n" "$t" --serial) |
+        awk -F'|' -v dim="$dim" '/^(Original|Serial RB|Tiled|Tiled\+Aligned) *\|/ {
+            name = $1; gsub(/ +$/, "", name); gsub(/ /, "", $3);
+            printf "%s %s,%s\n", dim, name, $3 }'
+}
+
+# 运行算子基准，输出 "内核,中位数时间(ms)"
+run_op() {
+    local bin="$1" name="$2" t="$3"
+    (cd "$RUN_DIR" && "$bin/${name}_$FLAVOR" "$t") |
+        awk -v name="$name" '/^Median time/ { printf "%s,%s\n", name, $(NF-1) }'
+}
+
+# 一次完整的基准扫描，每行 "内核,规模,时间"
+run_suite() {
+    local bin="$1" t="$2"
+    local n
+    for n in $SIZES_2D; do
+        run_gs "$bin" 2d "$n" "$t" | sed "s/,/,$n,/"
+    done
+    for n in $SIZES_3D; do
+        run_gs "$bin" 3d "$n" "$t" | sed "s/,/,$n,/"
+    done
+    run_op "$bin" conv_openmp_optimized "$t" | sed "s/,/,conv1,/"
+    run_op "$bin" avgpool_openmp_memory "$t" | sed "s/,/,pool1,/"
+}
+
+# 重复 REPEAT 次，每个 (内核,规模) 取最小时间
+measure() {
+    local bin="$1" out="$2" r
+    : > "$out.raw"
+    for r in $(seq "$REPEAT"); do
+        run_suite "$bin" "$THREADS" >> "$out.raw"
+    done
+    awk -F, '{ k = $1 "," $2; if (!(k in best) || $3 < best[k]) best[k] = $3 }
+             END { for (k in best) print k "," best[k] }' "$out.raw" | sort > "$out"
+}
+
+mkdir -p "$OUT" "$RUN_DIR"
+
+echo "[1/5] Baseline build ($FLAVOR)"
+build "$OUT/base" -DITER_PGO=OFF "$@"
+
+echo "[2/5] Instrumented build"
+rm -rf "$PROFILE_DIR"
+build "$OUT/pgo" -DITER_PGO=GENERATE -DITER_PGO_DIR="$PROFILE_DIR" "$@"
+
+echo "[3/5] Training: 2D N={$SIZES_2D}, 3D N={$SIZES_3D}, threads={$TRAIN_THREADS}"
+for t in $TRAIN_THREADS; do
+    for n in $SIZES_2D; do run_gs "$OUT/pgo/bin" 2d "$n" "$t" > /dev/null; done
+    for n in $SIZES_3D; do run_gs "$OUT/pgo/bin" 3d "$n" "$t" > /dev/null; done
+    run_op "$OUT/pgo/bin" conv_openmp_optimized "$t" > /dev/null
+    run_op "$OUT/pgo/bin" avgpool_openmp_memory "$t" > /dev/null
+done
+
+echo "[4/5] Profile-guided rebuild"
+build "$OUT/pgo" -DITER_PGO=USE -DITER_PGO_DIR="$PROFILE_DIR" "$@"
+
+echo "[5/5] Measuring baseline vs PGO ($THREADS threads, best of $REPEAT)"
+measure "$OUT/base/bin" "$OUT/base_times.csv"
+measure "$OUT/pgo/bin" "$OUT/pgo_times.csv"
+
+REPORT="$OUT/pgo_report.csv"
+echo "kernel,size,base_ms,pgo_ms,speedup" > "$REPORT"
+join -t, -j1 \
+    <(awk -F, '{ print $1 "|" $2 "," $3 }' "$OUT/base_times.csv" | sort) \
+    <(awk -F, '{ print $1 "|" $2 "," $3 }' "$OUT/pgo_times.csv" | sort) |
+    awk -F, '{ split($1, k, "|"); printf "%s,%s,%s,%s,%.3f\n", k[1], k[2], $2, $3, ($3 > 0 ? $2 / $3 : 0) }' |
+    sort -t, -k1,1 -k2,2n >> "$REPORT"
+
+echo
+printf "%-26s %8s %12s %12s %9s\n" "Kernel" "Size" "Base(ms)" "PGO(ms)" "Speedup"
+tail -n +2 "$REPORT" | awk -F, '{ printf "%-26s %8s %12.2f %12.2f %8.3fx\n", $1, $2, $3, $4, $5 }'
+echo
+echo "Report written to $REPORT"